@@ -0,0 +1,692 @@
+#include "format_utils.hpp"
+#include "format_utils_io.hpp"
+
+// NOLINTBEGIN
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+// -----------------------------------------------------------------------------
+// Allocation counting
+// -----------------------------------------------------------------------------
+
+static std::atomic<size_t> g_allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+
+template<typename T>
+static void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+struct BenchConfig
+{
+    size_t iterations{ 20'000 };
+    size_t repetitions{ 5 };
+    std::string_view filter{};
+    size_t dump_mb{ 0 };
+};
+
+static BenchConfig g_config{};
+
+static auto parse_count(std::string_view arg) -> size_t
+{
+    return std::max(1UZ, static_cast<size_t>(std::strtoull(arg.data(), nullptr, 10)));
+}
+
+// cost_factor scales down the iteration count for benchmarks whose single op is much more expensive.
+template<typename Fn>
+static void run_bench(std::string_view name, Fn&& fn, size_t cost_factor = 1)
+{
+    if (!g_config.filter.empty() && !name.contains(g_config.filter)) {
+        return;
+    }
+
+    const auto iterations{ std::max(1UZ, g_config.iterations / cost_factor) };
+
+    std::string out;
+    out.reserve(16 * 1024);
+    for (auto i{ 0UZ }; i < iterations / 10 + 1; ++i) {
+        out.clear();
+        fn(out);
+    }
+
+    std::vector<double> ns_per_op{};
+    auto bytes{ 0UZ };
+    auto allocations{ 0UZ };
+    for (auto rep{ 0UZ }; rep < g_config.repetitions; ++rep) {
+        bytes = 0;
+        const auto allocs_before{ g_allocations.load(std::memory_order_relaxed) };
+        const auto start{ std::chrono::steady_clock::now() };
+        for (auto i{ 0UZ }; i < iterations; ++i) {
+            out.clear();
+            fn(out);
+            bytes += out.size();
+            do_not_optimize(out.data());
+        }
+        const auto stop{ std::chrono::steady_clock::now() };
+        allocations = g_allocations.load(std::memory_order_relaxed) - allocs_before;
+        ns_per_op.push_back(std::chrono::duration<double, std::nano>(stop - start).count() /
+                            static_cast<double>(iterations));
+    }
+
+    std::ranges::sort(ns_per_op);
+    const auto median{ ns_per_op[ns_per_op.size() / 2] };
+    const auto bytes_per_op{ static_cast<double>(bytes) / static_cast<double>(iterations) };
+    const auto allocs_per_op{ static_cast<double>(allocations) / static_cast<double>(iterations) };
+    std::fputs(std::format("{:<40} {:>12.1f} {:>12.1f} {:>10.2f} {:>10.1f}\n",
+                           name,
+                           median,
+                           bytes_per_op / median * 1e3,
+                           allocs_per_op,
+                           bytes_per_op)
+                 .c_str(),
+               stdout);
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark types
+// -----------------------------------------------------------------------------
+
+struct Shallow
+{
+    int id;
+    double value;
+    bool active;
+};
+
+struct Level3
+{
+    int x;
+    int y;
+};
+
+struct Level2
+{
+    int id;
+    Level3 point;
+};
+
+struct Level1
+{
+    std::string name;
+    Level2 child;
+};
+
+struct Deep
+{
+    int id;
+    Level1 child;
+    bool active;
+};
+
+struct Wide
+{
+    int m00;
+    int m01;
+    int m02;
+    int m03;
+    int m04;
+    int m05;
+    int m06;
+    int m07;
+    int m08;
+    int m09;
+    int m10;
+    int m11;
+    int m12;
+    int m13;
+    int m14;
+    int m15;
+    int m16;
+    int m17;
+    int m18;
+    int m19;
+    int m20;
+    int m21;
+    int m22;
+    int m23;
+    int m24;
+    int m25;
+    int m26;
+    int m27;
+    int m28;
+    int m29;
+    int m30;
+    int m31;
+    int m32;
+    int m33;
+    int m34;
+    int m35;
+    int m36;
+    int m37;
+    int m38;
+    int m39;
+    int m40;
+    int m41;
+    int m42;
+    int m43;
+    int m44;
+    int m45;
+    int m46;
+    int m47;
+    int m48;
+    int m49;
+};
+
+class Account
+{
+  public:
+    Account(int id, std::string owner, double balance)
+      : m_id(id)
+      , m_owner(std::move(owner))
+      , m_balance(balance)
+    {
+    }
+
+    int getId() const { return m_id; }
+    const std::string& getOwner() const { return m_owner; }
+    double getBalance() const { return m_balance; }
+
+  private:
+    int m_id;
+    std::string m_owner;
+    double m_balance;
+};
+
+template<>
+struct fmtu::Adapter<Account>
+{
+    using Fields = std::tuple<fmtu::Field<"id", &Account::getId>,
+                              fmtu::Field<"owner", &Account::getOwner>,
+                              fmtu::Field<"balance", &Account::getBalance>>;
+};
+
+enum class State
+{
+    Idle,
+    Connecting,
+    Connected,
+    Disconnecting,
+    Failed
+};
+
+struct StreamableVec
+{
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const StreamableVec& v)
+{
+    return os << "Vec(" << v.x << ", " << v.y << ")";
+}
+
+struct ToStringVec
+{
+    int x;
+    int y;
+
+    std::string toString() const { return "Vec(" + std::to_string(x) + ", " + std::to_string(y) + ")"; }
+};
+
+struct FormatToVec
+{
+    int x;
+    int y;
+
+    template<typename OutIt>
+    OutIt format_to(OutIt out) const
+    {
+        return std::format_to(out, "Vec({}, {})", x, y);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Benchmarks
+// -----------------------------------------------------------------------------
+
+static void bench_reflectable()
+{
+    const Shallow shallow{ 42, 3.14, true };
+    run_bench("reflectable/shallow/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", shallow);
+    });
+    run_bench("reflectable/shallow/verbose", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:v}", shallow);
+    });
+    run_bench("reflectable/shallow/pretty", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:p}", shallow);
+    });
+    run_bench("reflectable/shallow/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       "[ Shallow: {{ id: {}, value: {}, active: {} }} ]",
+                       shallow.id,
+                       shallow.value,
+                       shallow.active);
+    });
+
+    const Deep deep{ 1, { "child", { 2, { 3, 4 } } }, true };
+    run_bench("reflectable/deep/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", deep);
+    });
+    run_bench("reflectable/deep/pretty", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:p}", deep);
+    });
+    run_bench("reflectable/deep/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       "[ Deep: {{ id: {}, child: [ Level1: {{ name: {}, child: [ Level2: {{ id: {}, "
+                       "point: [ Level3: {{ x: {}, y: {} }} ] }} ] }} ], active: {} }} ]",
+                       deep.id,
+                       deep.child.name,
+                       deep.child.child.id,
+                       deep.child.child.point.x,
+                       deep.child.child.point.y,
+                       deep.active);
+    });
+    run_bench("reflectable/deep/pretty_baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       "Deep: {{\n  id: {},\n  child: {{\n    name: {},\n    child: {{\n      id: {},\n"
+                       "      point: {{\n        x: {},\n        y: {}\n      }}\n    }}\n  }},\n"
+                       "  active: {}\n}}",
+                       deep.id,
+                       deep.child.name,
+                       deep.child.child.id,
+                       deep.child.child.point.x,
+                       deep.child.child.point.y,
+                       deep.active);
+    });
+
+    const Wide wide{ 0, 7, 14, 21, 28, 35, 42, 49, 56, 63, 70, 77, 84, 91, 98, 105, 112, 119, 126,
+                      133, 140, 147, 154, 161, 168, 175, 182, 189, 196, 203, 210, 217, 224, 231, 238,
+                      245, 252, 259, 266, 273, 280, 287, 294, 301, 308, 315, 322, 329, 336, 343 };
+    run_bench("reflectable/wide/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", wide);
+    });
+    run_bench("reflectable/wide/pretty", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:p}", wide);
+    });
+    run_bench("reflectable/wide/baseline", [&](std::string& out) {
+        const auto& w{ wide };
+        std::format_to(std::back_inserter(out),
+                       "[ Wide: {{ m00: {}, m01: {}, m02: {}, m03: {}, m04: {}, m05: {}, m06: {}, "
+                       "m07: {}, m08: {}, m09: {}, m10: {}, m11: {}, m12: {}, m13: {}, m14: {}, "
+                       "m15: {}, m16: {}, m17: {}, m18: {}, m19: {}, m20: {}, m21: {}, m22: {}, "
+                       "m23: {}, m24: {}, m25: {}, m26: {}, m27: {}, m28: {}, m29: {}, m30: {}, "
+                       "m31: {}, m32: {}, m33: {}, m34: {}, m35: {}, m36: {}, m37: {}, m38: {}, "
+                       "m39: {}, m40: {}, m41: {}, m42: {}, m43: {}, m44: {}, m45: {}, m46: {}, "
+                       "m47: {}, m48: {}, m49: {} }} ]",
+                       w.m00, w.m01, w.m02, w.m03, w.m04, w.m05, w.m06, w.m07, w.m08, w.m09, w.m10,
+                       w.m11, w.m12, w.m13, w.m14, w.m15, w.m16, w.m17, w.m18, w.m19, w.m20, w.m21,
+                       w.m22, w.m23, w.m24, w.m25, w.m26, w.m27, w.m28, w.m29, w.m30, w.m31, w.m32,
+                       w.m33, w.m34, w.m35, w.m36, w.m37, w.m38, w.m39, w.m40, w.m41, w.m42, w.m43,
+                       w.m44, w.m45, w.m46, w.m47, w.m48, w.m49);
+    });
+
+#ifdef FMTU_ENABLE_JSON
+    run_bench("reflectable/shallow/json", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:j}", shallow);
+    });
+    run_bench("reflectable/shallow/json_baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       R"({{"id":{},"value":{},"active":{}}})",
+                       shallow.id,
+                       shallow.value,
+                       shallow.active);
+    });
+    run_bench("reflectable/deep/json", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:j}", deep);
+    });
+    run_bench("reflectable/deep/pretty_json", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:pj}", deep);
+    });
+    run_bench("reflectable/wide/json", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:j}", wide);
+    });
+#endif
+#ifdef FMTU_ENABLE_BEVE
+    run_bench("reflectable/shallow/beve", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:b}", shallow);
+    });
+    run_bench("reflectable/wide/beve", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:b}", wide);
+    });
+#endif
+#ifdef FMTU_ENABLE_TOML
+    run_bench("reflectable/shallow/toml", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:t}", shallow);
+    });
+    run_bench("reflectable/deep/toml", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:t}", deep);
+    });
+#endif
+}
+
+static void bench_runtime_parse()
+{
+    // Patterns only known at runtime go through parse_fmt_opts on every call.
+    Shallow shallow{ 42, 3.14, true };
+    Account account{ 7, "Alice", 1234.5 };
+    auto state{ State::Connected };
+    const std::string compact_pattern{ "{}" };
+    const std::string pretty_pattern{ "{:vp}" };
+    const std::string enum_pattern{ "{:v}" };
+
+    run_bench("runtime/reflectable/compact", [&](std::string& out) {
+        std::vformat_to(std::back_inserter(out), compact_pattern, std::make_format_args(shallow));
+    });
+    run_bench("runtime/reflectable/pretty", [&](std::string& out) {
+        std::vformat_to(std::back_inserter(out), pretty_pattern, std::make_format_args(shallow));
+    });
+    run_bench("runtime/adapter/pretty", [&](std::string& out) {
+        std::vformat_to(std::back_inserter(out), pretty_pattern, std::make_format_args(account));
+    });
+    run_bench("runtime/enum/verbose", [&](std::string& out) {
+        std::vformat_to(std::back_inserter(out), enum_pattern, std::make_format_args(state));
+    });
+}
+
+static void bench_adapter()
+{
+    const Account account{ 7, "Alice", 1234.5 };
+    run_bench("adapter/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", account);
+    });
+    run_bench("adapter/verbose", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:v}", account);
+    });
+    run_bench("adapter/pretty", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:p}", account);
+    });
+    run_bench("adapter/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       "[ Account: {{ id: {}, owner: {}, balance: {} }} ]",
+                       account.getId(),
+                       account.getOwner(),
+                       account.getBalance());
+    });
+
+#ifdef FMTU_ENABLE_JSON
+    run_bench("adapter/json", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:j}", account);
+    });
+    run_bench("adapter/json_baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       R"({{"id":{},"owner":"{}","balance":{}}})",
+                       account.getId(),
+                       account.getOwner(),
+                       account.getBalance());
+    });
+#endif
+#ifdef FMTU_ENABLE_YAML
+    run_bench("adapter/yaml", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:y}", account);
+    });
+#endif
+#ifdef FMTU_ENABLE_BEVE
+    run_bench("adapter/beve", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:b}", account);
+    });
+#endif
+#ifdef FMTU_ENABLE_TOML
+    run_bench("adapter/toml", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:t}", account);
+    });
+#endif
+}
+
+static void bench_enum()
+{
+    const auto state{ State::Disconnecting };
+    run_bench("enum/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", state);
+    });
+    run_bench("enum/verbose", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:v}", state);
+    });
+    run_bench("enum/baseline", [&](std::string& out) {
+        static constexpr std::array NAMES{
+            "Idle"sv, "Connecting"sv, "Connected"sv, "Disconnecting"sv, "Failed"sv
+        };
+        std::format_to(std::back_inserter(out), "{}", NAMES[std::to_underlying(state)]);
+    });
+    run_bench("enum/from_string", [&](std::string& out) {
+        static constexpr std::array NAMES{
+            "Idle"sv, "Connecting"sv, "Connected"sv, "Disconnecting"sv, "Failed"sv, "Unknown"sv
+        };
+        for (auto name : NAMES) {
+            out.push_back(fmtu::enum_from_string<State>(name).has_value() ? '1' : '0');
+        }
+    });
+}
+
+static void bench_optional_and_pointer()
+{
+    const std::optional<Shallow> opt{ Shallow{ 1, 2.5, false } };
+    run_bench("optional/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", opt);
+    });
+    run_bench("optional/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       "[ [ Shallow: {{ id: {}, value: {}, active: {} }} ] ]",
+                       opt->id,
+                       opt->value,
+                       opt->active);
+    });
+
+    const Shallow shallow{ 42, 3.14, true };
+    const Shallow* ptr{ &shallow };
+    run_bench("pointer/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", ptr);
+    });
+    run_bench("pointer/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out),
+                       "[ ({}) -> [ Shallow: {{ id: {}, value: {}, active: {} }} ] ]",
+                       static_cast<const void*>(ptr),
+                       ptr->id,
+                       ptr->value,
+                       ptr->active);
+    });
+}
+
+static void bench_custom()
+{
+    const StreamableVec streamable{ 3, 4 };
+    run_bench("streamable/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", streamable);
+    });
+    run_bench("streamable/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "Vec({}, {})", streamable.x, streamable.y);
+    });
+
+    const ToStringVec to_string_vec{ 3, 4 };
+    run_bench("to_string/compact", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", to_string_vec);
+    });
+    const FormatToVec format_to_vec{ 3, 4 };
+    run_bench("to_string/format_to", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{}", format_to_vec);
+    });
+    run_bench("to_string/baseline", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "Vec({}, {})", to_string_vec.x, to_string_vec.y);
+    });
+}
+
+static void bench_cached()
+{
+    const Deep deep{ 1, { "child", { 2, { 3, 4 } } }, true };
+    fmtu::Cached<Deep> cached{ deep };
+    run_bench("cached/deep/pretty_hit", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:p}", cached);
+    });
+    auto id{ 0 };
+    run_bench("cached/deep/pretty_miss", [&](std::string& out) {
+        cached.modify().id = ++id;
+        std::format_to(std::back_inserter(out), "{:p}", cached);
+    });
+    run_bench("cached/deep/pretty_direct", [&](std::string& out) {
+        std::format_to(std::back_inserter(out), "{:p}", deep);
+    });
+}
+
+static void bench_range()
+{
+    std::vector<Shallow> shallows(100'000);
+    for (auto i{ 0UZ }; i < shallows.size(); ++i) {
+        shallows[i] = { static_cast<int>(i), static_cast<double>(i) * 0.5, i % 2 == 0 };
+    }
+    run_bench(
+      "range/100k/sequential",
+      [&](std::string& out) {
+          auto it{ std::back_inserter(out) };
+          for (auto i{ 0UZ }; i < shallows.size(); ++i) {
+              it = std::format_to(it, "{}{}", i == 0 ? ""sv : ", "sv, shallows[i]);
+          }
+      },
+      10'000);
+    run_bench(
+      "range/100k/parallel",
+      [&](std::string& out) { out = fmtu::format_range_parallel(shallows); },
+      10'000);
+    run_bench(
+      "range/100k/pretty_parallel",
+      [&](std::string& out) { out = fmtu::format_range_parallel(shallows, "p", "\n"); },
+      10'000);
+}
+
+// Writes dump_mb megabytes of pretty-printed records to a file once per sink, see --dump-mb.
+template<typename Fn>
+static void run_dump(std::string_view name, Fn&& fn)
+{
+    if (g_config.dump_mb == 0 || (!g_config.filter.empty() && !name.contains(g_config.filter))) {
+        return;
+    }
+
+    const auto path{ (std::filesystem::temp_directory_path() / "format_bench_dump.txt").string() };
+    const auto target_bytes{ g_config.dump_mb * 1024 * 1024 };
+    const auto allocs_before{ g_allocations.load(std::memory_order_relaxed) };
+    const auto start{ std::chrono::steady_clock::now() };
+    const auto [records, bytes] = fn(path.c_str(), target_bytes);
+    const auto stop{ std::chrono::steady_clock::now() };
+    const auto allocations{ g_allocations.load(std::memory_order_relaxed) - allocs_before };
+    std::filesystem::remove(path);
+
+    const auto ns{ std::chrono::duration<double, std::nano>(stop - start).count() };
+    std::fputs(std::format("{:<40} {:>12.1f} {:>12.1f} {:>10.2f} {:>10.1f}\n",
+                           name,
+                           ns / static_cast<double>(records),
+                           static_cast<double>(bytes) / ns * 1e3,
+                           static_cast<double>(allocations) / static_cast<double>(records),
+                           static_cast<double>(bytes) / static_cast<double>(records))
+                 .c_str(),
+               stdout);
+}
+
+static void bench_dump()
+{
+    const Deep deep{ 1, { "child", { 2, { 3, 4 } } }, true };
+    run_dump("dump/pretty/ofstream", [&](const char* path, size_t target_bytes) {
+        std::ofstream file{ path, std::ios::binary };
+        auto records{ 0UZ };
+        auto bytes{ 0UZ };
+        while (bytes < target_bytes) {
+            const auto record{ std::format("{:p}\n", deep) };
+            file << record;
+            bytes += record.size();
+            ++records;
+        }
+        return std::pair{ records, bytes };
+    });
+#if FMTU_HAS_POSIX_IO
+    run_dump("dump/pretty/mmap_writer", [&](const char* path, size_t target_bytes) {
+        fmtu::MmapWriter writer{ path };
+        auto records{ 0UZ };
+        while (writer.size() < target_bytes) {
+            std::format_to(writer.out(), "{:p}\n", deep);
+            ++records;
+        }
+        const auto bytes{ writer.size() };
+        writer.close();
+        return std::pair{ records, bytes };
+    });
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (auto i{ 0UZ }; i < args.size(); ++i) {
+        if (args[i] == "--iterations" && i + 1 < args.size()) {
+            g_config.iterations = parse_count(args[++i]);
+        }
+        else if (args[i] == "--repetitions" && i + 1 < args.size()) {
+            g_config.repetitions = parse_count(args[++i]);
+        }
+        else if (args[i] == "--filter" && i + 1 < args.size()) {
+            g_config.filter = args[++i];
+        }
+        else if (args[i] == "--dump-mb" && i + 1 < args.size()) {
+            g_config.dump_mb = parse_count(args[++i]);
+        }
+        else {
+            std::fputs("Usage: format_bench [--iterations N] [--repetitions N] [--filter SUBSTRING] "
+                       "[--dump-mb N]\n",
+                       stderr);
+            return 1;
+        }
+    }
+
+    std::fputs(std::format("{:<40} {:>12} {:>12} {:>10} {:>10}\n",
+                           "benchmark",
+                           "ns/op",
+                           "MB/s",
+                           "allocs/op",
+                           "bytes/op")
+                 .c_str(),
+               stdout);
+
+    bench_reflectable();
+    bench_runtime_parse();
+    bench_adapter();
+    bench_enum();
+    bench_optional_and_pointer();
+    bench_custom();
+    bench_cached();
+    bench_range();
+    bench_dump();
+
+    return 0;
+}
+
+// NOLINTEND
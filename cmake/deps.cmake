@@ -17,7 +17,7 @@ target_include_directories(
     ${reflect_SOURCE_DIR}
 )
 
-if(FMTU_ENABLE_JSON OR FMTU_ENABLE_YAML OR FMTU_ENABLE_TOML)
+if(FMTU_ENABLE_JSON OR FMTU_ENABLE_YAML OR FMTU_ENABLE_TOML OR FMTU_ENABLE_BEVE)
     FetchContent_Declare(
         glaze
         GIT_REPOSITORY  https://github.com/stephenberry/glaze.git
@@ -38,6 +38,9 @@ if(FMTU_ENABLE_JSON OR FMTU_ENABLE_YAML OR FMTU_ENABLE_TOML)
     if(FMTU_ENABLE_TOML)
         target_compile_definitions(glaze_defines INTERFACE FMTU_ENABLE_TOML)
     endif()
+    if(FMTU_ENABLE_BEVE)
+        target_compile_definitions(glaze_defines INTERFACE FMTU_ENABLE_BEVE)
+    endif()
 endif()
 
 if(BUILD_TESTS)
@@ -0,0 +1,60 @@
+module;
+
+// Global module fragment: the non-modular dependencies of format_utils.hpp. Keep in sync with the header.
+#ifdef FMTU_ENABLE_JSON
+#include <glaze/json.hpp>
+#endif
+#ifdef FMTU_ENABLE_YAML
+#include <glaze/yaml.hpp>
+#endif
+#ifdef FMTU_ENABLE_TOML
+#include <glaze/toml.hpp>
+#endif
+#ifdef FMTU_ENABLE_BEVE
+#include <glaze/beve.hpp>
+#endif
+
+#include <reflect>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef FMTU_ENABLE_STATS
+#include <chrono>
+#include <deque>
+#endif
+
+export module fmtu;
+
+// Namespace fmtu is exported. The std::formatter and glz::meta specializations are not exported declarations,
+// but they are reachable from every importer and are picked up by std::format as usual.
+#define FMTU_MODULE
+#include "format_utils.hpp"
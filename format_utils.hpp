@@ -1,5 +1,12 @@
 #pragma once
 
+// format_utils.cppm includes the dependencies in its global module fragment and then this header in the
+// module purview with FMTU_MODULE defined, so that `import fmtu;` exports everything in namespace fmtu.
+#ifdef FMTU_MODULE
+#define FMTU_EXPORT export
+#else
+#define FMTU_EXPORT
+
 #ifdef FMTU_ENABLE_JSON
 #include <glaze/json.hpp>
 #endif
@@ -9,43 +16,80 @@
 #ifdef FMTU_ENABLE_TOML
 #include <glaze/toml.hpp>
 #endif
+#ifdef FMTU_ENABLE_BEVE
+#include <glaze/beve.hpp>
+#endif
 
 #include <reflect>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <format>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <locale>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
 #include <optional>
+#include <ostream>
 #include <ranges>
-#include <sstream>
+#include <span>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#ifdef FMTU_ENABLE_STATS
+#include <chrono>
+#include <deque>
+#endif
+#endif
+
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
 #endif
 
-namespace fmtu
+FMTU_EXPORT namespace fmtu
 {
 #ifdef FMTU_ENABLE_JSON
-    static constexpr bool IS_JSON_ENABLED{ true };
+    inline constexpr bool IS_JSON_ENABLED{ true };
 #else
-    static constexpr bool IS_JSON_ENABLED{ false };
+    inline constexpr bool IS_JSON_ENABLED{ false };
 #endif
 #ifdef FMTU_ENABLE_YAML
-    static constexpr bool IS_YAML_ENABLED{ true };
+    inline constexpr bool IS_YAML_ENABLED{ true };
 #else
-    static constexpr bool IS_YAML_ENABLED{ false };
+    inline constexpr bool IS_YAML_ENABLED{ false };
 #endif
 #ifdef FMTU_ENABLE_TOML
-    static constexpr bool IS_TOML_ENABLED{ true };
+    inline constexpr bool IS_TOML_ENABLED{ true };
+#else
+    inline constexpr bool IS_TOML_ENABLED{ false };
+#endif
+#ifdef FMTU_ENABLE_BEVE
+    inline constexpr bool IS_BEVE_ENABLED{ true };
 #else
-    static constexpr bool IS_TOML_ENABLED{ false };
+    inline constexpr bool IS_BEVE_ENABLED{ false };
+#endif
+#ifdef FMTU_ENABLE_STATS
+    inline constexpr bool IS_STATS_ENABLED{ true };
+#else
+    inline constexpr bool IS_STATS_ENABLED{ false };
 #endif
 
     namespace detail
@@ -310,9 +354,21 @@ namespace fmtu
           !std::is_fundamental_v<std::remove_cvref_t<T>> && !std::is_array_v<std::remove_cvref_t<T>> &&
           !SmartPtr<T>;
 
+        template<typename T>
+        concept HasFormatTo = std::is_class_v<std::remove_cvref_t<T>> &&
+                              requires(const T& t, std::format_context::iterator out) {
+                                  { t.format_to(out) } -> std::same_as<std::format_context::iterator>;
+                              };
+
+        template<typename T>
+        concept HasAppendTo =
+          std::is_class_v<std::remove_cvref_t<T>> && requires(const T& t, std::string& str) {
+              requires(requires { t.append_to(str); } || requires { append_to(t, str); });
+          };
+
         template<typename T>
         concept HasToString = std::is_class_v<std::remove_cvref_t<T>> && requires(const T& t) {
-            requires(requires {
+            requires(HasFormatTo<T> || HasAppendTo<T> || requires {
                 { t.to_string() } -> std::convertible_to<std::string_view>;
             } || requires {
                 { t.toString() } -> std::convertible_to<std::string_view>;
@@ -333,6 +389,16 @@ namespace fmtu
         {
         };
 
+        template<typename T>
+        struct is_optional : std::false_type // NOLINT(readability-identifier-naming)
+        {
+        };
+
+        template<typename T>
+        struct is_optional<std::optional<T>> : std::true_type // NOLINT(readability-identifier-naming)
+        {
+        };
+
         template<typename A, typename T>
         concept ArrayOf = is_array<std::remove_cvref_t<A>>::value &&
                           std::convertible_to<typename std::remove_cvref_t<A>::value_type, T>;
@@ -381,6 +447,103 @@ namespace fmtu
         }
         // clang-format on
 
+        template<ScopedEnum T>
+        constexpr auto enum_index(T value) -> uint64_t
+        {
+            return static_cast<uint64_t>(std::to_underlying(value)) -
+                   static_cast<uint64_t>(reflect::enum_min(T{}));
+        }
+
+        // Dense name table over [enum_min, enum_max], so a lookup is a bounds check and an indexed load. The
+        // span is bounded by reflect's enum range, gaps in sparse enums simply hold an empty name.
+        template<ScopedEnum T>
+        struct EnumNames
+        {
+            static constexpr auto NAMES = [] {
+                std::array<std::string_view, enum_index(static_cast<T>(reflect::enum_max(T{}))) + 1U> names{};
+                for (auto value : underlying_enumerators<T>()) {
+                    names[enum_index(static_cast<T>(value))] = reflect::enum_name(static_cast<T>(value));
+                }
+                return names;
+            }();
+        };
+
+        template<ScopedEnum T>
+        constexpr auto enum_name(T value) -> std::string_view
+        {
+            constexpr const auto& names{ EnumNames<std::remove_cvref_t<T>>::NAMES };
+            const auto index{ enum_index(value) };
+            return index < names.size() ? names[index] : std::string_view{};
+        }
+
+        constexpr auto enum_name_hash(std::string_view name, uint32_t seed) -> uint32_t
+        {
+            auto hash{ seed ^ 2166136261U };
+            for (char c : name) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 16777619U;
+            }
+            return hash ^ (hash >> 15U);
+        }
+
+        struct PerfectHashParams
+        {
+            size_t size;
+            uint32_t seed;
+        };
+
+        // Searches a seed and power of two table size so that every enumerator name lands in its own slot.
+        template<ScopedEnum T>
+        consteval auto enum_perfect_hash_params() -> PerfectHashParams
+        {
+            constexpr auto enums{ enumerators<T>() };
+            for (auto size{ std::bit_ceil(std::max(enums.size() * 2, 2UZ)) };; size *= 2) {
+                for (auto seed{ 0U }; seed < 256U; ++seed) {
+                    std::vector<bool> used(size, false);
+                    auto collision{ false };
+                    for (auto e : enums) {
+                        auto slot{ enum_name_hash(enum_name(e), seed) & (size - 1) };
+                        collision = collision || used[slot];
+                        used[slot] = true;
+                    }
+                    if (!collision) {
+                        return { .size = size, .seed = seed };
+                    }
+                }
+            }
+        }
+
+        // Parsing is one hash, one indexed load and one compare.
+        template<ScopedEnum T>
+        struct EnumParser
+        {
+            struct Slot
+            {
+                std::string_view name{};
+                T value{};
+            };
+
+            static constexpr PerfectHashParams PARAMS{ enum_perfect_hash_params<T>() };
+
+            static constexpr auto TABLE = [] {
+                std::array<Slot, PARAMS.size> table{};
+                for (auto e : enumerators<T>()) {
+                    auto slot{ enum_name_hash(enum_name(e), PARAMS.seed) & (PARAMS.size - 1) };
+                    table[slot] = { .name = enum_name(e), .value = e };
+                }
+                return table;
+            }();
+
+            static constexpr auto parse(std::string_view name) -> std::optional<T>
+            {
+                const auto& slot{ TABLE[enum_name_hash(name, PARAMS.seed) & (PARAMS.size - 1)] };
+                if (slot.name.empty() || slot.name != name) {
+                    return std::nullopt;
+                }
+                return slot.value;
+            }
+        };
+
         // ---------- Adapter ----------
 
         template<typename T>
@@ -408,6 +571,17 @@ namespace fmtu
         using remove_member_pointer_t = typename remove_member_pointer<T>::type;
     }
 
+    // Parses an enumerator name, either plain ("Value") or verbose ("Type::Value").
+    template<detail::ScopedEnum T>
+    constexpr auto enum_from_string(std::string_view name) -> std::optional<T>
+    {
+        constexpr auto type{ detail::type_name<T>() };
+        if (name.size() > type.size() + 2 && name.starts_with(type) && name.substr(type.size(), 2) == "::") {
+            name.remove_prefix(type.size() + 2);
+        }
+        return detail::EnumParser<T>::parse(name);
+    }
+
     template<typename T>
     struct Adapter
     {
@@ -504,6 +678,33 @@ namespace fmtu
             static consteval auto numMembers() -> size_t { return MEMBER_NAMES.size(); };
         };
 
+        template<typename T>
+            requires HasAdapter<T> || Reflectable<T>
+        consteval auto class_info()
+        {
+            if constexpr (HasAdapter<T>) {
+                return std::type_identity<AdapterInfo<T>>{};
+            }
+            else {
+                return std::type_identity<ReflectableInfo<T>>{};
+            }
+        }
+
+        // AdapterInfo or ReflectableInfo, whichever formatter T uses.
+        template<typename T>
+        using class_info_t = typename decltype(class_info<T>())::type;
+
+        template<typename T>
+            requires HasAdapter<T> || Reflectable<T>
+        struct ClassFormatter;
+
+        // True if T is formatted by ClassFormatter, directly or through FMTU_DECLARE_FORMATTER. A class
+        // with a std::formatter of its own is formatted by that formatter, as a single field of its parent.
+        template<typename T>
+        concept ClassFormatted =
+          (HasAdapter<T> || Reflectable<T>) &&
+          std::is_base_of_v<ClassFormatter<std::remove_cvref_t<T>>, std::formatter<std::remove_cvref_t<T>>>;
+
         // ---------- Formatting ----------
 
         template<typename T>
@@ -515,6 +716,21 @@ namespace fmtu
             { T::numMembers() } -> std::convertible_to<size_t>;
         };
 
+        // Every (type, level) pattern is generated exactly once, by the initializer of CLASS_FORMAT or
+        // CLASS_PRETTY_FORMAT, and parents copy the finished patterns of their children. Calling
+        // class_format() recursively instead would regenerate each subtree (and its size) for every ancestor.
+        template<FormatInfo Info>
+        consteval auto class_format();
+
+        template<FormatInfo Info>
+        inline constexpr auto CLASS_FORMAT{ class_format<Info>() };
+
+        template<FormatInfo Info, size_t Level = 0>
+        consteval auto class_pretty_format();
+
+        template<FormatInfo Info, size_t Level = 0>
+        inline constexpr auto CLASS_PRETTY_FORMAT{ class_pretty_format<Info, Level>() };
+
         template<FormatInfo Info>
         consteval auto class_format_size() -> size_t
         {
@@ -523,18 +739,30 @@ namespace fmtu
             size += Info::NAME.size();
             size += std::size(": {{ "sv);
 
-            for (auto i{ 0UZ }; i < Info::numMembers(); ++i) {
-                size += Info::MEMBER_NAMES[i].size();
-                size += std::size(": {}"sv);
-                if (i < Info::numMembers() - 1) {
-                    size += std::size(", "sv);
-                }
-            }
+            [&]<size_t... Is>(std::index_sequence<Is...>) -> void {
+                ([&](auto i) -> void {
+                    using MemberType = std::tuple_element_t<i, typename Info::MemberTypes>;
+
+                    size += Info::MEMBER_NAMES[i].size();
+                    if constexpr (ClassFormatted<MemberType>) {
+                        size += std::size(": "sv);
+                        size += std::string_view{ CLASS_FORMAT<class_info_t<MemberType>> }.size();
+                    }
+                    else {
+                        size += std::size(": {}"sv);
+                    }
+                    if constexpr (i < Info::numMembers() - 1) {
+                        size += std::size(", "sv);
+                    }
+                }(std::integral_constant<size_t, Is>{}), ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
 
             size += std::size(" }} ]"sv);
             return size;
         }
 
+        // Nested members formatted by ClassFormatter are inlined into the parent pattern, so a whole object
+        // hierarchy is formatted in a single pass over its flattened members.
         template<FormatInfo Info>
         consteval auto class_format()
         {
@@ -551,19 +779,29 @@ namespace fmtu
             append(Info::NAME);
             append(": {{ ");
 
-            for (auto i{ 0UZ }; i < Info::numMembers(); ++i) {
-                append(Info::MEMBER_NAMES[i]);
-                append(": {}");
-                if (i < Info::numMembers() - 1) {
-                    append(", ");
-                }
-            }
+            [&]<size_t... Is>(std::index_sequence<Is...>) -> void {
+                ([&](auto i) -> void {
+                    using MemberType = std::tuple_element_t<i, typename Info::MemberTypes>;
+
+                    append(Info::MEMBER_NAMES[i]);
+                    if constexpr (ClassFormatted<MemberType>) {
+                        append(": ");
+                        append(CLASS_FORMAT<class_info_t<MemberType>>);
+                    }
+                    else {
+                        append(": {}");
+                    }
+                    if constexpr (i < Info::numMembers() - 1) {
+                        append(", ");
+                    }
+                }(std::integral_constant<size_t, Is>{}), ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
 
             append(" }} ]");
             return reflect::fixed_string<char, fmt.size()>(fmt.data());
         }
 
-        static constexpr std::string_view PRETTY_INDENT{ "  " };
+        inline constexpr std::string_view PRETTY_INDENT{ "  " };
 
         template<FormatInfo Info, size_t Level = 0>
         consteval auto class_pretty_format_size() -> size_t
@@ -583,13 +821,10 @@ namespace fmtu
 
                     size += (Level + 1) * PRETTY_INDENT.size();
                     size += Info::MEMBER_NAMES[i].size();
-                    if constexpr (HasAdapter<MemberType>) {
-                        size += std::size(": "sv);
-                        size += class_pretty_format_size<AdapterInfo<MemberType>, Level + 1>();
-                    }
-                    else if constexpr (Reflectable<MemberType>) {
+                    if constexpr (ClassFormatted<MemberType>) {
+                        using MemberInfo = class_info_t<MemberType>;
                         size += std::size(": "sv);
-                        size += class_pretty_format_size<ReflectableInfo<MemberType>, Level + 1>();
+                        size += std::string_view{ CLASS_PRETTY_FORMAT<MemberInfo, Level + 1> }.size();
                     }
                     else {
                         size += std::size(": {}"sv);
@@ -606,7 +841,7 @@ namespace fmtu
             return size;
         }
 
-        template<FormatInfo Info, size_t Level = 0>
+        template<FormatInfo Info, size_t Level>
         consteval auto class_pretty_format()
         {
             std::array<char, class_pretty_format_size<Info, Level>()> fmt{};
@@ -635,13 +870,9 @@ namespace fmtu
                     }
                     append(Info::MEMBER_NAMES[i]);
 
-                    if constexpr (HasAdapter<MemberType>) {
-                        append(": ");
-                        append(class_pretty_format<AdapterInfo<MemberType>, Level + 1>());
-                    }
-                    else if constexpr (Reflectable<MemberType>) {
+                    if constexpr (ClassFormatted<MemberType>) {
                         append(": ");
-                        append(class_pretty_format<ReflectableInfo<MemberType>, Level + 1>());
+                        append(CLASS_PRETTY_FORMAT<class_info_t<MemberType>, Level + 1>);
                     }
                     else {
                         append(": {}");
@@ -661,6 +892,82 @@ namespace fmtu
             return reflect::fixed_string<char, fmt.size()>(fmt.data());
         }
 
+        // ---------- Memory Resource ----------
+
+        // Resource for internal temporaries of the fmtu::format(resource, ...) call running on this thread.
+        inline auto scoped_resource() -> std::pmr::memory_resource*&
+        {
+            thread_local std::pmr::memory_resource* resource{ nullptr };
+            return resource;
+        }
+
+        class ResourceScope
+        {
+          public:
+            explicit ResourceScope(std::pmr::memory_resource* resource)
+              : m_previous{ std::exchange(scoped_resource(), resource) }
+            {
+            }
+
+            ResourceScope(const ResourceScope&) = delete;
+            ResourceScope(ResourceScope&&) = delete;
+            auto operator=(const ResourceScope&) -> ResourceScope& = delete;
+            auto operator=(ResourceScope&&) -> ResourceScope& = delete;
+
+            ~ResourceScope() { scoped_resource() = m_previous; }
+
+          private:
+            std::pmr::memory_resource* m_previous;
+        };
+
+        // ---------- Text Support ----------
+
+        template<typename OutIt>
+        auto write_text(OutIt out, std::string_view text) -> OutIt
+        {
+            return std::ranges::copy(text, std::move(out)).out;
+        }
+
+        // append_to() implementations write into a per-thread buffer that keeps its capacity. A nested call,
+        // e.g. an append_to() that formats an append-style member, finds the buffer busy and appends to a
+        // local string instead, like IteratorStream does for nested operator<<.
+        struct AppendBuffer
+        {
+            std::string str;
+            bool busy{ false };
+        };
+
+        inline auto append_buffer() -> AppendBuffer&
+        {
+            thread_local AppendBuffer buffer{};
+            return buffer;
+        }
+
+        template<typename OutIt, typename Appender>
+        auto write_appended(OutIt out, Appender&& appender) -> OutIt
+        {
+            auto& shared{ append_buffer() };
+            if (shared.busy) {
+                std::string local{};
+                std::forward<Appender>(appender)(local);
+                return write_text(std::move(out), local);
+            }
+
+            struct Release
+            {
+                AppendBuffer& buffer;
+                ~Release()
+                {
+                    buffer.str.clear();
+                    buffer.busy = false;
+                }
+            } release{ shared };
+            shared.busy = true;
+            shared.str.clear();
+            std::forward<Appender>(appender)(shared.str);
+            return write_text(std::move(out), shared.str);
+        }
+
         // ---------- Format arguments ----------
 
         template<typename T>
@@ -670,7 +977,7 @@ namespace fmtu
                 return std::forward<T>(field);
             }
             else {
-                return "-";
+                return "-"sv;
             }
         };
 
@@ -682,6 +989,34 @@ namespace fmtu
             return Tuple(std::forward<Args>(args)...);
         };
 
+        // Members of an rvalue owner are forwarded as rvalues, so they are stored by value in the flat
+        // tuple instead of as references into a temporary that dies before formatting.
+        template<typename Owner, typename Member>
+        constexpr auto forward_member(Member&& member) -> decltype(auto)
+        {
+            if constexpr (std::is_lvalue_reference_v<Owner>) {
+                return std::forward<Member>(member);
+            }
+            else {
+                return std::move(member); // NOLINT(bugprone-move-forwarding-reference)
+            }
+        }
+
+        template<typename T>
+        constexpr auto make_flat_args_tuple(T&& val);
+
+        // A member is flattened like its parent only if ClassFormatter formats it, see class_format().
+        template<typename T>
+        constexpr auto make_flat_member_args(T&& member)
+        {
+            if constexpr (ClassFormatted<T>) {
+                return make_flat_args_tuple(std::forward<T>(member));
+            }
+            else {
+                return fmtu::detail::make_args_tuple(fmtu::detail::check_arg(std::forward<T>(member)));
+            }
+        }
+
         template<typename T>
         constexpr auto make_flat_args_tuple(T&& val)
         {
@@ -689,13 +1024,13 @@ namespace fmtu
             if constexpr (fmtu::detail::HasAdapter<Type>) {
                 using Fields = typename fmtu::Adapter<Type>::Fields;
                 return [&]<size_t... Is>(std::index_sequence<Is...>) -> auto {
-                    return std::tuple_cat(
-                      make_flat_args_tuple(std::invoke(std::tuple_element_t<Is, Fields>::VALUE, val))...);
+                    return std::tuple_cat(make_flat_member_args(
+                      forward_member<T>(std::invoke(std::tuple_element_t<Is, Fields>::VALUE, val)))...);
                 }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
             }
             else if constexpr (fmtu::detail::Reflectable<Type>) {
                 return [&]<size_t... Is>(std::index_sequence<Is...>) -> auto {
-                    return std::tuple_cat(make_flat_args_tuple(reflect::get<Is>(val))...);
+                    return std::tuple_cat(make_flat_member_args(forward_member<T>(reflect::get<Is>(val)))...);
                 }(std::make_index_sequence<reflect::size<Type>()>{});
             }
             else {
@@ -703,89 +1038,505 @@ namespace fmtu
             }
         };
 
-        // ---------- Format Specs ----------
+        // ---------- Compiled Format ----------
 
-        enum class FmtSpecs : char
+        template<typename T, typename Ctx>
+        auto format_value(const T& value, Ctx& ctx) -> Ctx::iterator
         {
-            Verbose = 'v',
-            Pretty = 'p',
-            Json = 'j',
-            Yaml = 'y',
-            Toml = 't'
-        };
-        static constexpr auto NUM_FMT_SPECS{ num_enumerators<FmtSpecs>() };
-
-        static constexpr std::array COMPATIBLE_FMT_SPEC_PAIRS{
-            std::make_pair(FmtSpecs::Verbose, FmtSpecs::Pretty),
-            std::make_pair(FmtSpecs::Pretty, FmtSpecs::Json)
-        };
-
-        static_assert(is_array_of_pairs_unique(COMPATIBLE_FMT_SPEC_PAIRS),
-                      "Compatible format specifier pairs not unique");
+            std::formatter<T, char> formatter{};
+            // std::format hands a "{}" member formatter a spec range that starts at the closing brace.
+            std::basic_format_parse_context<char> parse_ctx{ "}"sv };
+            formatter.parse(parse_ctx);
+            return formatter.format(value, ctx);
+        }
 
-        consteval auto generate_incompatible_specs()
+        // Generated class patterns only contain "{}" placeholders and escaped braces, so they can be split
+        // into literal segments at compile time. Formatting then copies the segments and calls each
+        // argument's formatter directly, without runtime pattern parsing or type-erased format args.
+        template<typename Visitor>
+        constexpr auto visit_pattern(std::string_view pattern, const Visitor& visitor) -> void
         {
-            FixedMap<FmtSpecs, FixedVector<FmtSpecs, NUM_FMT_SPECS - 1>, NUM_FMT_SPECS> incompatible_specs;
+            for (auto i{ 0UZ }; i < pattern.size(); ++i) {
+                if (i + 1 < pattern.size() && pattern[i] == '{' && pattern[i + 1] == '}') {
+                    visitor(std::nullopt);
+                    ++i;
+                    continue;
+                }
+                if (i + 1 < pattern.size() && (pattern[i] == '{' || pattern[i] == '}') &&
+                    pattern[i + 1] == pattern[i]) {
+                    ++i;
+                }
+                visitor(std::optional<char>{ pattern[i] });
+            }
+        }
 
-            constexpr auto specs{ enumerators<FmtSpecs>() };
-            for (auto spec : specs) {
-                FixedVector<FmtSpecs, NUM_FMT_SPECS - 1> incompatible{};
+        template<auto Fmt>
+        struct CompiledFormat
+        {
+            static constexpr std::string_view PATTERN{ Fmt };
 
-                auto incompatible_view{ specs | std::views::filter([spec](auto other) -> bool {
-                    if (spec == other) {
-                        return false;
+            static constexpr auto SIZES = [] {
+                std::pair<size_t, size_t> sizes{};
+                visit_pattern(PATTERN, [&sizes](std::optional<char> c) -> void {
+                    if (c) {
+                        ++sizes.first;
                     }
-                    return std::ranges::none_of(COMPATIBLE_FMT_SPEC_PAIRS, [&](const auto& pair) -> bool {
-                        return (pair.first == spec && pair.second == other) ||
-                               (pair.first == other && pair.second == spec);
-                    });
-                }) };
-
-                std::ranges::for_each(incompatible_view, [&](auto val) -> void { incompatible.add(val); });
+                    else {
+                        ++sizes.second;
+                    }
+                });
+                return sizes;
+            }();
+            static constexpr auto NUM_ARGS{ SIZES.second };
+
+            static constexpr auto DATA = [] {
+                std::pair<std::array<char, SIZES.first>, std::array<size_t, NUM_ARGS + 2>> data{};
+                auto& [text, offsets] = data;
+                auto size{ 0UZ };
+                auto arg{ 1UZ };
+                visit_pattern(PATTERN, [&](std::optional<char> c) -> void {
+                    if (c) {
+                        text[size++] = *c;
+                    }
+                    else {
+                        offsets[arg++] = size;
+                    }
+                });
+                offsets[arg] = size;
+                return data;
+            }();
 
-                incompatible_specs.insert(std::make_pair(spec, incompatible));
+            // Segment i precedes argument i, the last segment follows the last argument.
+            static constexpr auto segment(size_t i) -> std::string_view
+            {
+                const auto& [text, offsets] = DATA;
+                return { text.data() + offsets[i], offsets[i + 1] - offsets[i] };
             }
+        };
 
-            return incompatible_specs;
+        template<auto Fmt, typename Ctx, typename... Args>
+        auto format_compiled(Ctx& ctx, const Args&... args) -> Ctx::iterator
+        {
+            using Compiled = CompiledFormat<Fmt>;
+            static_assert(Compiled::NUM_ARGS == sizeof...(Args), "Argument count does not match pattern");
+
+            auto index{ 0UZ };
+            (
+              [&] -> void {
+                  ctx.advance_to(write_text(ctx.out(), Compiled::segment(index++)));
+                  ctx.advance_to(format_value(args, ctx));
+              }(),
+              ...);
+            return write_text(ctx.out(), Compiled::segment(index));
         }
 
-        static constexpr auto FMT_INCOMPATIBEL_SPECS{ generate_incompatible_specs() };
+        // ---------- Diff Support ----------
 
-        // ---------- Glaze Support ----------
+        template<size_t I, typename T>
+        constexpr auto class_member(const T& t) -> decltype(auto)
+        {
+            if constexpr (HasAdapter<T>) {
+                return std::invoke(std::tuple_element_t<I, typename Adapter<T>::Fields>::VALUE, t);
+            }
+            else {
+                return reflect::get<I>(t);
+            }
+        }
 
-        static constexpr std::array GLAZE_FMT_SPECS{ FmtSpecs::Json, FmtSpecs::Yaml, FmtSpecs::Toml };
+        // Ranges compared element by element. Ranges of themselves (std::filesystem::path) are compared as a
+        // whole, since recursing into their elements would never end.
+        template<typename T>
+        concept ElementwiseRange =
+          std::ranges::input_range<const T> &&
+          !std::same_as<std::remove_cvref_t<std::ranges::range_value_t<const T>>, std::remove_cvref_t<T>>;
 
-#ifdef FMTU_ENABLE_GLAZE
-        enum class GlazeFormat : uint32_t // NOLINT(performance-enum-size)
-        {
-            Json = glz::JSON,
-            Yaml = glz::YAML,
-            Toml = glz::TOML
-        };
+        template<typename T>
+        concept TupleLike = !std::ranges::input_range<T> && requires { std::tuple_size<T>::value; };
 
-        template<typename T, GlazeFormat Fmt>
-        consteval auto is_type_glaze_serializable() -> bool;
+        template<typename T>
+        consteval auto is_value_comparable() -> bool;
 
-        template<FormatInfo Info, GlazeFormat Fmt>
-        consteval auto is_info_glaze_serializable() -> bool
+        template<typename... Ts>
+        consteval auto are_values_comparable(std::type_identity<std::tuple<Ts...>> /*unused*/) -> bool
         {
-            using MemberTypes = typename Info::MemberTypes;
-            return []<size_t... Is>(std::index_sequence<Is...>) -> bool {
-                return (is_type_glaze_serializable<std::tuple_element_t<Is, MemberTypes>, Fmt>() && ...);
-            }(std::make_index_sequence<Info::numMembers()>{});
+            return (is_value_comparable<Ts>() && ...);
         }
 
-        template<typename T, GlazeFormat Fmt>
-        consteval auto is_type_glaze_serializable() -> bool
+        template<typename T, size_t... Is>
+        consteval auto are_elements_comparable(std::index_sequence<Is...>) -> bool
         {
-            if constexpr (HasAdapter<T>) {
-                return is_info_glaze_serializable<AdapterInfo<T>, Fmt>();
+            return (is_value_comparable<std::tuple_element_t<Is, T>>() && ...);
+        }
+
+        // True if values_equal() can compare two T. Classes compare member by member, so they need no
+        // operator==, and so do the elements of ranges, optionals and tuple-likes. The standard types'
+        // operator== is not constrained on the elements, so std::equality_comparable alone would accept
+        // e.g. std::vector<Agg> for an Agg without operator== and the comparison would fail to compile.
+        template<typename T>
+        consteval auto is_value_comparable() -> bool
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (HasAdapter<Type> || Reflectable<Type>) {
+                return are_values_comparable(std::type_identity<typename class_info_t<Type>::MemberTypes>{});
             }
-            else if constexpr (Reflectable<T>) {
-                return is_info_glaze_serializable<ReflectableInfo<T>, Fmt>();
+            else if constexpr (is_optional<Type>::value) {
+                return is_value_comparable<typename Type::value_type>();
+            }
+            else if constexpr (ElementwiseRange<Type>) {
+                return is_value_comparable<std::ranges::range_value_t<const Type>>();
+            }
+            else if constexpr (TupleLike<Type>) {
+                return are_elements_comparable<Type>(std::make_index_sequence<std::tuple_size_v<Type>>{});
             }
             else {
-                return glz::write_supported<T, std::to_underlying(Fmt)>;
+                return std::equality_comparable<Type>;
+            }
+        }
+
+        template<typename T>
+        concept ValueComparable = is_value_comparable<T>();
+
+        template<ValueComparable T>
+        constexpr auto values_equal(const T& lhs, const T& rhs) -> bool
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (HasAdapter<Type> || Reflectable<Type>) {
+                return [&]<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                    return (values_equal(class_member<Is>(lhs), class_member<Is>(rhs)) && ...);
+                }(std::make_index_sequence<class_info_t<Type>::numMembers()>{});
+            }
+            else if constexpr (is_optional<Type>::value) {
+                return lhs.has_value() == rhs.has_value() && (!lhs.has_value() || values_equal(*lhs, *rhs));
+            }
+            else if constexpr (ElementwiseRange<Type>) {
+                return std::ranges::equal(lhs, rhs, [](const auto& left, const auto& right) -> bool {
+                    return values_equal(left, right);
+                });
+            }
+            else if constexpr (TupleLike<Type>) {
+                return [&]<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                    return (values_equal(std::get<Is>(lhs), std::get<Is>(rhs)) && ...);
+                }(std::make_index_sequence<std::tuple_size_v<Type>>{});
+            }
+            else {
+                return lhs == rhs;
+            }
+        }
+
+        // Dotted member path of a diff entry as a chain of parents on the stack, so no string is built.
+        struct DiffPath
+        {
+            const DiffPath* parent{ nullptr };
+            std::string_view name{};
+        };
+
+        template<typename Ctx>
+        auto write_diff_path(Ctx& ctx, const DiffPath& path) -> void
+        {
+            if (path.parent != nullptr) {
+                write_diff_path(ctx, *path.parent);
+                ctx.advance_to(write_text(ctx.out(), "."sv));
+            }
+            ctx.advance_to(write_text(ctx.out(), path.name));
+        }
+
+        template<typename T, typename Ctx>
+        auto write_member_value(const T& value, Ctx& ctx) -> void
+        {
+            if constexpr (std::formattable<T, char>) {
+                ctx.advance_to(format_value(value, ctx));
+            }
+            else {
+                ctx.advance_to(write_text(ctx.out(), "-"sv));
+            }
+        }
+
+        // Writes "path: old -> new" for every changed leaf member, recursing into nested classes. Containers
+        // and optionals of classes are compared element by element; members that can't be compared at all
+        // (no operator== and no reflectable elements) are skipped.
+        template<typename T, typename Ctx>
+        auto write_diff(Ctx& ctx,
+                        const T& old_value,
+                        const T& new_value,
+                        const DiffPath* parent,
+                        std::string_view separator,
+                        bool& first) -> void
+        {
+            using Info = class_info_t<T>;
+            [&]<size_t... Is>(std::index_sequence<Is...>) -> void {
+                (
+                  [&] -> void {
+                      const DiffPath path{ parent, Info::MEMBER_NAMES[Is] };
+                      decltype(auto) old_member = class_member<Is>(old_value);
+                      decltype(auto) new_member = class_member<Is>(new_value);
+                      using Member = std::remove_cvref_t<decltype(old_member)>;
+                      if constexpr (HasAdapter<Member> || Reflectable<Member>) {
+                          write_diff(ctx, old_member, new_member, &path, separator, first);
+                      }
+                      else if constexpr (ValueComparable<Member>) {
+                          if (values_equal(old_member, new_member)) {
+                              return;
+                          }
+                          if (!std::exchange(first, false)) {
+                              ctx.advance_to(write_text(ctx.out(), separator));
+                          }
+                          write_diff_path(ctx, path);
+                          ctx.advance_to(write_text(ctx.out(), ": "sv));
+                          write_member_value(old_member, ctx);
+                          ctx.advance_to(write_text(ctx.out(), " -> "sv));
+                          write_member_value(new_member, ctx);
+                      }
+                  }(),
+                  ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
+        }
+
+        // ---------- Projection ----------
+
+        template<FormatInfo Info>
+        consteval auto member_index(std::string_view name) -> size_t
+        {
+            const auto it{ std::ranges::find(Info::MEMBER_NAMES, name) };
+            if (it == Info::MEMBER_NAMES.end()) {
+                throw std::format_error("Projected member does not exist");
+            }
+            return static_cast<size_t>(std::ranges::distance(Info::MEMBER_NAMES.begin(), it));
+        }
+
+        // Format info of the named members of T in the listed order, so the projected patterns are generated
+        // by class_format / class_pretty_format like the ones of the full class.
+        template<typename T, reflect::fixed_string... Names>
+        struct ProjectionInfo
+        {
+            using ClassInfo = class_info_t<T>;
+            using Type = typename ClassInfo::Type;
+            static constexpr std::string_view NAME{ ClassInfo::NAME };
+            using ClassMemberTypes = typename ClassInfo::MemberTypes;
+            static constexpr std::array<size_t, sizeof...(Names)> INDICES{
+                member_index<ClassInfo>(Names)...
+            };
+            using MemberTypes =
+              std::tuple<std::tuple_element_t<member_index<ClassInfo>(Names), ClassMemberTypes>...>;
+            static constexpr std::array<std::string_view, sizeof...(Names)> MEMBER_NAMES{
+                std::string_view{ Names }...
+            };
+            static consteval auto numMembers() -> size_t { return MEMBER_NAMES.size(); };
+        };
+
+        template<typename Info, typename T>
+        constexpr auto make_projected_args_tuple(const T& t)
+        {
+            return [&]<size_t... Is>(std::index_sequence<Is...>) -> auto {
+                return std::tuple_cat(make_flat_member_args(class_member<Info::INDICES[Is]>(t))...);
+            }(std::make_index_sequence<Info::numMembers()>{});
+        }
+
+        // ---------- Content Hash ----------
+
+        constexpr auto hash_combine(size_t seed, size_t value) -> size_t
+        {
+            return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6U) + (seed >> 2U));
+        }
+
+        template<typename T>
+        consteval auto is_content_hashable() -> bool;
+
+        template<FormatInfo Info>
+        consteval auto is_info_content_hashable() -> bool
+        {
+            using MemberTypes = typename Info::MemberTypes;
+            return []<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                return (is_content_hashable<std::tuple_element_t<Is, MemberTypes>>() && ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
+        }
+
+        template<typename T>
+        consteval auto is_content_hashable() -> bool
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (HasAdapter<Type> || Reflectable<Type>) {
+                return is_info_content_hashable<class_info_t<Type>>();
+            }
+            else if constexpr (SmartPtr<Type>) {
+                return is_content_hashable<typename Type::element_type*>();
+            }
+            else if constexpr (ValuePtr<Type>) {
+                return is_content_hashable<std::remove_pointer_t<Type>>();
+            }
+            else if constexpr (requires(const Type& t) { std::hash<Type>{}(t); }) {
+                return true;
+            }
+            else if constexpr (is_optional<Type>::value) {
+                return is_content_hashable<typename Type::value_type>();
+            }
+            else if constexpr (std::ranges::input_range<Type>) {
+                return is_content_hashable<std::ranges::range_value_t<Type>>();
+            }
+            else {
+                return false;
+            }
+        }
+
+        template<typename T>
+        concept ContentHashable = is_content_hashable<T>();
+
+        // Hash over the values of all members, recursing into nested classes, pointees, optionals and ranges.
+        template<ContentHashable T>
+        auto content_hash(const T& value, size_t seed = 0) -> size_t
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (HasAdapter<Type> || Reflectable<Type>) {
+                [&]<size_t... Is>(std::index_sequence<Is...>) -> void {
+                    ((seed = content_hash(class_member<Is>(value), seed)), ...);
+                }(std::make_index_sequence<class_info_t<Type>::numMembers()>{});
+                return seed;
+            }
+            else if constexpr (SmartPtr<Type>) {
+                return content_hash(value.get(), seed);
+            }
+            else if constexpr (ValuePtr<Type>) {
+                // The pointer formatter writes the address and the pointee, so both go into the hash.
+                seed = hash_combine(seed, std::hash<const void*>{}(value));
+                return value != nullptr ? content_hash(*value, seed) : seed;
+            }
+            else if constexpr (CharPtr<Type>) {
+                return value != nullptr ? content_hash(std::string_view{ value }, hash_combine(seed, 1))
+                                        : hash_combine(seed, 0);
+            }
+            else if constexpr (std::floating_point<Type> && (sizeof(Type) == 4 || sizeof(Type) == 8)) {
+                // std::hash treats 0.0 and -0.0 alike, but they format differently.
+                using Bits = std::conditional_t<sizeof(Type) == 4, uint32_t, uint64_t>;
+                return hash_combine(seed, std::hash<Bits>{}(std::bit_cast<Bits>(value)));
+            }
+            else if constexpr (requires { std::hash<Type>{}(value); }) {
+                return hash_combine(seed, std::hash<Type>{}(value));
+            }
+            else if constexpr (is_optional<Type>::value) {
+                return value ? content_hash(*value, hash_combine(seed, 1)) : hash_combine(seed, 0);
+            }
+            else {
+                auto count{ 0UZ };
+                for (const auto& element : value) {
+                    seed = content_hash(element, seed);
+                    ++count;
+                }
+                return hash_combine(seed, count);
+            }
+        }
+
+        // ---------- Format Specs ----------
+
+        enum class FmtSpecs : char
+        {
+            Verbose = 'v',
+            Pretty = 'p',
+            Json = 'j',
+            Yaml = 'y',
+            Toml = 't',
+            Beve = 'b',
+            Sparse = 's'
+        };
+        inline constexpr auto NUM_FMT_SPECS{ num_enumerators<FmtSpecs>() };
+
+        inline constexpr std::array COMPATIBLE_FMT_SPEC_PAIRS{
+            std::make_pair(FmtSpecs::Verbose, FmtSpecs::Pretty),
+            std::make_pair(FmtSpecs::Pretty, FmtSpecs::Json),
+            std::make_pair(FmtSpecs::Sparse, FmtSpecs::Pretty),
+            std::make_pair(FmtSpecs::Sparse, FmtSpecs::Json)
+        };
+
+        static_assert(is_array_of_pairs_unique(COMPATIBLE_FMT_SPEC_PAIRS),
+                      "Compatible format specifier pairs not unique");
+
+        consteval auto generate_incompatible_specs()
+        {
+            FixedMap<FmtSpecs, FixedVector<FmtSpecs, NUM_FMT_SPECS - 1>, NUM_FMT_SPECS> incompatible_specs;
+
+            constexpr auto specs{ enumerators<FmtSpecs>() };
+            for (auto spec : specs) {
+                FixedVector<FmtSpecs, NUM_FMT_SPECS - 1> incompatible{};
+
+                auto incompatible_view{ specs | std::views::filter([spec](auto other) -> bool {
+                    if (spec == other) {
+                        return false;
+                    }
+                    return std::ranges::none_of(COMPATIBLE_FMT_SPEC_PAIRS, [&](const auto& pair) -> bool {
+                        return (pair.first == spec && pair.second == other) ||
+                               (pair.first == other && pair.second == spec);
+                    });
+                }) };
+
+                std::ranges::for_each(incompatible_view, [&](auto val) -> void { incompatible.add(val); });
+
+                incompatible_specs.insert(std::make_pair(spec, incompatible));
+            }
+
+            return incompatible_specs;
+        }
+
+        inline constexpr auto FMT_INCOMPATIBEL_SPECS{ generate_incompatible_specs() };
+
+        // "{:<spec>}" pattern built at runtime without allocating, for entry points taking a spec string.
+        class SpecPattern
+        {
+          public:
+            static constexpr size_t MAX_SPEC_SIZE{ 13 };
+
+            explicit SpecPattern(std::string_view spec)
+            {
+                if (spec.size() > MAX_SPEC_SIZE) {
+                    throw std::format_error("Invalid format specifier");
+                }
+                auto end{ std::ranges::copy(spec, m_pattern.begin() + 2).out };
+                *end++ = '}';
+                m_size = static_cast<size_t>(end - m_pattern.begin());
+            }
+
+            auto view() const -> std::string_view { return { m_pattern.data(), m_size }; }
+
+          private:
+            std::array<char, MAX_SPEC_SIZE + 3> m_pattern{ '{', ':' };
+            size_t m_size{ 0UZ };
+        };
+
+        // ---------- Glaze Support ----------
+
+        inline constexpr std::array GLAZE_FMT_SPECS{
+            FmtSpecs::Json, FmtSpecs::Yaml, FmtSpecs::Toml, FmtSpecs::Beve
+        };
+
+#ifdef FMTU_ENABLE_GLAZE
+        enum class GlazeFormat : uint32_t // NOLINT(performance-enum-size)
+        {
+            Json = glz::JSON,
+            Yaml = glz::YAML,
+            Toml = glz::TOML,
+            Beve = glz::BEVE
+        };
+
+        template<typename T, GlazeFormat Fmt>
+        consteval auto is_type_glaze_serializable() -> bool;
+
+        template<FormatInfo Info, GlazeFormat Fmt>
+        consteval auto is_info_glaze_serializable() -> bool
+        {
+            using MemberTypes = typename Info::MemberTypes;
+            return []<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                return (is_type_glaze_serializable<std::tuple_element_t<Is, MemberTypes>, Fmt>() && ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
+        }
+
+        template<typename T, GlazeFormat Fmt>
+        consteval auto is_type_glaze_serializable() -> bool
+        {
+            if constexpr (HasAdapter<T>) {
+                return is_info_glaze_serializable<AdapterInfo<T>, Fmt>();
+            }
+            else if constexpr (Reflectable<T>) {
+                return is_info_glaze_serializable<ReflectableInfo<T>, Fmt>();
+            }
+            else {
+                return glz::write_supported<T, std::to_underlying(Fmt)>;
             }
         }
 
@@ -798,137 +1549,1577 @@ namespace fmtu
             if constexpr (std::is_member_function_pointer_v<decltype(Field::VALUE)>) {
                 return glz::custom<nullptr, Field::VALUE>;
             }
-            else {
-                return Field::VALUE;
+            else {
+                return Field::VALUE;
+            }
+        }
+
+        template<typename T>
+        struct GlazeAdapter
+        {
+            using Fields = typename Adapter<T>::Fields;
+            // NOLINTNEXTLINE(readability-identifier-naming)
+            static constexpr auto value = []<size_t... Is>(std::index_sequence<Is...>) -> auto {
+                return std::apply(
+                  [](auto&&... args) -> auto { return glz::object(std::forward<decltype(args)>(args)...); },
+                  std::tuple_cat(std::make_tuple(std::tuple_element_t<Is, Fields>::NAME,
+                                                 glaze_field_value<std::tuple_element_t<Is, Fields>>())...));
+            }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+        };
+
+        template<typename T>
+        concept HasGlazeMeta = requires { glz::meta<std::remove_cvref_t<T>>::value; };
+#endif
+
+        // ---------- Format Opts ----------
+
+        struct FmtOpts
+        {
+            bool verbose;
+            bool pretty;
+            bool json;
+            bool yaml;
+            bool toml;
+            bool beve;
+            bool sparse;
+
+            constexpr auto operator==(const FmtOpts&) const -> bool = default;
+            constexpr operator bool(this const auto& self) { return self != FmtOpts{}; }
+        };
+
+        // clang-format off
+        inline constexpr FixedMap<FmtSpecs, bool FmtOpts::*, NUM_FMT_SPECS> FMT_SPECS_TO_OPTS{std::array{ 
+            std::make_pair(FmtSpecs::Verbose,   &FmtOpts::verbose),
+            std::make_pair(FmtSpecs::Pretty,    &FmtOpts::pretty),
+            std::make_pair(FmtSpecs::Json,      &FmtOpts::json),
+            std::make_pair(FmtSpecs::Yaml,      &FmtOpts::yaml),
+            std::make_pair(FmtSpecs::Toml,      &FmtOpts::toml),
+            std::make_pair(FmtSpecs::Beve,      &FmtOpts::beve),
+            std::make_pair(FmtSpecs::Sparse,    &FmtOpts::sparse)
+        }};
+        // clang-format on
+
+        // Every spec character maps to its option, its own bit and the bits of all specs it can't be
+        // combined with, so parsing is a single table load per character.
+        struct FmtSpecEntry
+        {
+            bool FmtOpts::*opt{ nullptr };
+            uint32_t bit{ 0U };
+            uint32_t incompatible{ 0U };
+        };
+
+        static_assert(NUM_FMT_SPECS <= 32, "Format specifier bitmask too small");
+
+        consteval auto generate_fmt_spec_table()
+        {
+            constexpr auto specs{ enumerators<FmtSpecs>() };
+            auto spec_bit = [&specs](FmtSpecs spec) -> uint32_t {
+                return 1U << std::ranges::distance(specs.begin(), std::ranges::find(specs, spec));
+            };
+
+            std::array<FmtSpecEntry, 256> table{};
+            for (auto spec : specs) {
+                auto& entry{ table[static_cast<unsigned char>(std::to_underlying(spec))] };
+                entry.opt = FMT_SPECS_TO_OPTS.at(spec).value();
+                entry.bit = spec_bit(spec);
+                for (auto other : FMT_INCOMPATIBEL_SPECS.at(spec).value()) {
+                    entry.incompatible |= spec_bit(other);
+                }
+            }
+
+            return table;
+        }
+
+        inline constexpr auto FMT_SPEC_TABLE{ generate_fmt_spec_table() };
+
+        template<FmtOpts AllowedOpts, typename Ctx>
+        constexpr auto parse_fmt_opts(Ctx& ctx, FmtOpts& active_opts) -> Ctx::iterator
+        {
+            auto it{ ctx.begin() };
+
+            auto incompatible_specs{ 0U };
+            while (it != ctx.end()) {
+                auto spec_char{ *it };
+                if (spec_char == '}') {
+                    return it;
+                }
+
+                const auto& entry{ FMT_SPEC_TABLE[static_cast<unsigned char>(spec_char)] };
+                if (entry.opt == nullptr || (incompatible_specs & entry.bit) != 0U ||
+                    !(AllowedOpts.*entry.opt)) {
+                    throw std::format_error("Invalid format specifier");
+                }
+                active_opts.*entry.opt = true;
+                incompatible_specs |= entry.incompatible;
+
+                ++it;
+            }
+
+            return it;
+        }
+
+#ifdef FMTU_ENABLE_GLAZE
+        // Glaze serializes into a per-thread buffer that keeps its capacity between calls, so in steady
+        // state the only cost on top of the serializer itself is a single copy into the format context.
+        // Inside fmtu::format(resource, ...) a buffer allocated from that resource is used instead.
+        inline auto glaze_buffer() -> std::string&
+        {
+            thread_local std::string buffer{};
+            return buffer;
+        }
+
+        template<typename Ctx, typename Writer>
+        auto write_glaze(Ctx& ctx, Writer&& writer, std::string_view error) -> Ctx::iterator
+        {
+            const auto write = [&](auto& buffer) -> Ctx::iterator {
+                if (std::forward<Writer>(writer)(buffer)) {
+                    return std::ranges::copy(error, ctx.out()).out;
+                }
+                return std::ranges::copy(buffer, ctx.out()).out;
+            };
+
+            if (auto* resource{ scoped_resource() }) {
+                std::pmr::string buffer{ resource };
+                return write(buffer);
+            }
+            auto& buffer{ glaze_buffer() };
+            buffer.clear();
+            return write(buffer);
+        }
+#endif
+
+        // ---------- Sparse Support ----------
+
+        inline constexpr std::string_view JSON_PRETTY_INDENT{ "   " };
+
+        // True if value equals its value-initialized default: classes compare member by member, optionals
+        // by has_value() and sized ranges other than std::array by emptiness, so none of them need an
+        // operator== of their own.
+        // Values that can't be compared are never treated as default.
+        template<typename T>
+        constexpr auto is_default_value(const T& value) -> bool
+        {
+            if constexpr (HasAdapter<T> || Reflectable<T>) {
+                return [&]<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                    return (is_default_value(class_member<Is>(value)) && ...);
+                }(std::make_index_sequence<class_info_t<T>::numMembers()>{});
+            }
+            else if constexpr (is_optional<T>::value) {
+                return !value.has_value();
+            }
+            else if constexpr (std::ranges::sized_range<const T> && !is_array<T>::value) {
+                return std::ranges::empty(value);
+            }
+            else if constexpr (std::default_initializable<T> && ValueComparable<T>) {
+                return values_equal(value, T{});
+            }
+            else {
+                return false;
+            }
+        }
+
+#ifdef FMTU_ENABLE_JSON
+        // A reflected class with its own glz::meta object. Glaze writes the keys and members listed there,
+        // which may rename, reorder or leave out reflected members.
+        template<typename T>
+        concept GlazeMetaObject = Reflectable<T> && HasGlazeMeta<T> && requires { glz::reflect<T>::values; };
+
+        template<GlazeMetaObject T, size_t I>
+        using glaze_member_t = std::remove_cvref_t<decltype(glz::get_member(
+          std::declval<const T&>(), get<I>(glz::reflect<T>::values)))>;
+
+        template<typename T>
+        consteval auto is_sparse_json_writable() -> bool;
+
+        template<typename... Ts>
+        consteval auto are_sparse_json_writable(std::type_identity<std::tuple<Ts...>> /*unused*/) -> bool
+        {
+            return (is_sparse_json_writable<Ts>() && ...);
+        }
+
+        // True if {:sj} can write T with the keys {:j} uses. glz::meta entries must be plain data members,
+        // anything Glaze computes on the fly (glz::custom, lambdas) has no value to compare to its default.
+        template<typename T>
+        consteval auto is_sparse_json_writable() -> bool
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (GlazeMetaObject<Type>) {
+                return []<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                    return ((std::is_member_object_pointer_v<
+                               std::remove_cvref_t<decltype(get<Is>(glz::reflect<Type>::values))>> &&
+                             is_sparse_json_writable<glaze_member_t<Type, Is>>()) &&
+                            ...);
+                }(std::make_index_sequence<glz::reflect<Type>::size>{});
+            }
+            else if constexpr (Reflectable<Type> && HasGlazeMeta<Type>) {
+                return false;
+            }
+            else if constexpr (HasAdapter<Type> || Reflectable<Type>) {
+                using MemberTypes = typename class_info_t<Type>::MemberTypes;
+                return are_sparse_json_writable(std::type_identity<MemberTypes>{});
+            }
+            else {
+                return GlazeSerializable<Type, GlazeFormat::Json>;
+            }
+        }
+
+        template<typename T>
+        concept SparseJsonWritable = is_sparse_json_writable<T>();
+#endif
+
+        // Calls visit(name, member) for every member of value. JSON output of a GlazeMetaObject visits the
+        // entries of its glz::meta instead, so the keys and their order match {:j}.
+        template<typename T, typename Visit>
+        auto for_each_sparse_member(const T& value, [[maybe_unused]] bool json, const Visit& visit) -> void
+        {
+#ifdef FMTU_ENABLE_JSON
+            if constexpr (GlazeMetaObject<T>) {
+                if (json) {
+                    [&]<size_t... Is>(std::index_sequence<Is...>) -> void {
+                        (visit(std::string_view{ glz::reflect<T>::keys[Is] },
+                               glz::get_member(value, get<Is>(glz::reflect<T>::values))),
+                         ...);
+                    }(std::make_index_sequence<glz::reflect<T>::size>{});
+                    return;
+                }
+            }
+#endif
+            using Info = class_info_t<T>;
+            [&]<size_t... Is>(std::index_sequence<Is...>) -> void {
+                (visit(Info::MEMBER_NAMES[Is], class_member<Is>(value)), ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
+        }
+
+        // Compact, pretty or JSON output of value without the members equal to their default. The layout
+        // matches the generated class patterns and Glaze's JSON output, only the skipped members differ.
+        template<typename T, typename Ctx>
+        auto write_sparse(Ctx& ctx, const T& value, const FmtOpts& fmt_opts, size_t level = 0) -> void
+        {
+            using Info = class_info_t<T>;
+            const auto text = [&ctx](std::string_view str) -> void {
+                ctx.advance_to(write_text(ctx.out(), str));
+            };
+            const auto new_line = [&](size_t depth) -> void {
+                text("\n"sv);
+                for (auto i{ 0UZ }; i < depth; ++i) {
+                    text(fmt_opts.json ? JSON_PRETTY_INDENT : PRETTY_INDENT);
+                }
+            };
+
+            if (fmt_opts.json) {
+                text("{"sv);
+            }
+            else if (fmt_opts.pretty) {
+                text(level == 0 ? std::string_view{ Info::NAME } : ""sv);
+                text(level == 0 ? ": {"sv : "{"sv);
+            }
+            else {
+                text("[ "sv);
+                text(Info::NAME);
+                text(": {"sv);
+            }
+
+            auto first{ true };
+            const auto write_member = [&](std::string_view name, const auto& member) -> void {
+                using Member = std::remove_cvref_t<decltype(member)>;
+                if (is_default_value(member)) {
+                    return;
+                }
+
+                const auto is_first{ std::exchange(first, false) };
+                if (fmt_opts.pretty) {
+                    text(is_first ? ""sv : ","sv);
+                    new_line(level + 1);
+                }
+                else if (!fmt_opts.json || !is_first) {
+                    text(fmt_opts.json ? ","sv : (is_first ? " "sv : ", "sv));
+                }
+
+                if (fmt_opts.json) {
+                    text("\""sv);
+                    text(name);
+                    text(fmt_opts.pretty ? "\": "sv : "\":"sv);
+                }
+                else {
+                    text(name);
+                    text(": "sv);
+                }
+
+                if constexpr (ClassFormatted<Member>) {
+                    write_sparse(ctx, member, fmt_opts, level + 1);
+                }
+#ifdef FMTU_ENABLE_JSON
+                else if (fmt_opts.json) {
+                    // parse() rejects {:sj} unless T is SparseJsonWritable, so Glaze can write every member.
+                    if constexpr (GlazeSerializable<Member, GlazeFormat::Json>) {
+                        ctx.advance_to(write_glaze(
+                          ctx,
+                          [&](auto& buffer) -> auto { return glz::write_json(member, buffer); },
+                          "JSON Error"));
+                    }
+                }
+#endif
+                else {
+                    write_member_value(member, ctx);
+                }
+            };
+            for_each_sparse_member(value, fmt_opts.json, write_member);
+
+            if (fmt_opts.pretty && !first) {
+                new_line(level);
+            }
+            text(fmt_opts.json || fmt_opts.pretty ? "}"sv : (first ? "} ]"sv : " } ]"sv));
+        }
+
+        template<FormatInfo Info, typename Ctx, typename T>
+        auto handle_class_opts(Ctx& ctx, const T& t, const FmtOpts& fmt_opts)
+          -> std::optional<typename Ctx::iterator>
+        {
+            if (fmt_opts.sparse) {
+                write_sparse(ctx, t, fmt_opts);
+                return ctx.out();
+            }
+#ifdef FMTU_ENABLE_JSON
+            if (fmt_opts.json) {
+                if constexpr (GlazeSerializable<T, GlazeFormat::Json>) {
+                    return write_glaze(
+                      ctx,
+                      [&](auto& buffer) -> auto {
+                          return fmt_opts.pretty ? glz::write<glz::opts{ .prettify = true }>(t, buffer)
+                                                 : glz::write_json(t, buffer);
+                      },
+                      "JSON Error");
+                }
+                else {
+                    throw std::format_error("Failed to format json");
+                }
+            }
+#endif
+#ifdef FMTU_ENABLE_YAML
+            if (fmt_opts.yaml) {
+                if constexpr (GlazeSerializable<T, GlazeFormat::Yaml> && HasGlazeMeta<T>) {
+                    return write_glaze(
+                      ctx,
+                      [&](auto& buffer) -> auto { return glz::write_yaml(t, buffer); },
+                      "YAML Error");
+                }
+                else {
+                    throw std::format_error("Failed to format yaml");
+                }
+            }
+#endif
+#ifdef FMTU_ENABLE_TOML
+            if (fmt_opts.toml) {
+                if constexpr (GlazeSerializable<T, GlazeFormat::Toml>) {
+                    return write_glaze(
+                      ctx,
+                      [&](auto& buffer) -> auto { return glz::write_toml(t, buffer); },
+                      "TOML Error");
+                }
+                else {
+                    throw std::format_error("Failed to format toml");
+                }
+            }
+#endif
+#ifdef FMTU_ENABLE_BEVE
+            if (fmt_opts.beve) {
+                if constexpr (GlazeSerializable<T, GlazeFormat::Beve>) {
+                    return write_glaze(
+                      ctx,
+                      [&](auto& buffer) -> auto { return glz::write_beve(t, buffer); },
+                      "BEVE Error");
+                }
+                else {
+                    throw std::format_error("Failed to format beve");
+                }
+            }
+#endif
+            if (fmt_opts.pretty) {
+                auto args_tuple{ fmtu::detail::make_flat_args_tuple(t) };
+                static constexpr auto fmt{ fmtu::detail::CLASS_PRETTY_FORMAT<Info> };
+                return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
+                    return fmtu::detail::format_compiled<fmt>(ctx, args...);
+                }, args_tuple);
+            }
+
+            return std::nullopt;
+        }
+
+        // ---------- Stream Support ----------
+
+        // Stream buffer that forwards operator<< output to a format output iterator. Writes are collected
+        // in a small put area and copied out in blocks instead of one virtual call per character.
+        template<typename OutIt>
+        class IteratorStreamBuf : public std::streambuf
+        {
+          public:
+            IteratorStreamBuf() { setp(m_buffer.data(), m_buffer.data() + m_buffer.size()); }
+
+            auto reset(OutIt out) -> void
+            {
+                m_out.emplace(std::move(out));
+                setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+            }
+
+            auto release() -> OutIt
+            {
+                flush();
+                return std::move(*m_out);
+            }
+
+          protected:
+            auto overflow(int_type ch) -> int_type override
+            {
+                flush();
+                if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                    *(*m_out)++ = traits_type::to_char_type(ch);
+                }
+                return traits_type::not_eof(ch);
+            }
+
+            auto xsputn(const char_type* s, std::streamsize n) -> std::streamsize override
+            {
+                if (n <= epptr() - pptr()) {
+                    std::ranges::copy(s, s + n, pptr());
+                    pbump(static_cast<int>(n));
+                    return n;
+                }
+                flush();
+                m_out.emplace(std::ranges::copy(s, s + n, std::move(*m_out)).out);
+                return n;
+            }
+
+            auto sync() -> int override
+            {
+                flush();
+                return 0;
+            }
+
+          private:
+            auto flush() -> void
+            {
+                m_out.emplace(std::ranges::copy(pbase(), pptr(), std::move(*m_out)).out);
+                setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+            }
+
+            std::optional<OutIt> m_out{};
+            std::array<char, 256> m_buffer{};
+        };
+
+        // Formatting state of a default constructed stream, restored after every operator<< call.
+        inline auto default_stream() -> const std::ostream&
+        {
+            static const std::ostream stream{ nullptr };
+            return stream;
+        }
+
+        template<typename OutIt>
+        struct IteratorStream
+        {
+            IteratorStreamBuf<OutIt> buf{};
+            std::ostream stream{ &buf };
+            bool busy{ false };
+
+            template<typename T>
+            auto write(OutIt out, const T& t) -> OutIt
+            {
+                struct Release
+                {
+                    IteratorStream& self;
+                    ~Release()
+                    {
+                        // Every call starts from a default constructed stream state, like a fresh
+                        // std::ostringstream would, even if operator<< left manipulators, a locale, an
+                        // exception mask or iword/pword data behind. Only register_callback() entries stay.
+                        self.stream.clear();
+                        self.stream.copyfmt(default_stream());
+                        self.busy = false;
+                    }
+                };
+
+                busy = true;
+                Release release{ *this };
+                // default_stream() keeps the global locale of its first use, a fresh stream would take the
+                // current one.
+                stream.imbue(std::locale());
+                buf.reset(std::move(out));
+                stream << t;
+                return buf.release();
+            }
+        };
+
+        // The stream is created once per thread and output iterator type. A nested call, e.g. an
+        // operator<< that formats another Streamable type, falls back to a local stream.
+        template<typename OutIt, typename T>
+        auto write_streamable(OutIt out, const T& t) -> OutIt
+        {
+            thread_local IteratorStream<OutIt> shared{};
+            if (shared.busy) {
+                IteratorStream<OutIt> local{};
+                return local.write(std::move(out), t);
+            }
+            return shared.write(std::move(out), t);
+        }
+
+        // ---------- Stats Support ----------
+
+#ifdef FMTU_ENABLE_STATS
+        // Latency bucket i counts calls that took less than 2^i ns (and at least 2^(i-1) ns).
+        inline constexpr size_t NUM_LATENCY_BUCKETS{ 32 };
+
+        // Counters of one (type, spec) pair on one thread. Only the owning thread writes them, so updates
+        // are plain relaxed load/store pairs and snapshot() reads them without stopping the writer.
+        struct StatsCounters
+        {
+            std::string_view type{};
+            uint32_t spec_bits{ 0U };
+            bool in_use{ true }; // Guarded by StatsRegistry::mutex.
+            std::atomic<uint64_t> calls{ 0 };
+            std::atomic<uint64_t> bytes{ 0 };
+            std::array<std::atomic<uint64_t>, NUM_LATENCY_BUCKETS> latency_ns{};
+        };
+
+        struct StatsRegistry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<StatsCounters>> counters;
+        };
+
+        inline auto stats_registry() -> StatsRegistry&
+        {
+            static StatsRegistry registry{};
+            return registry;
+        }
+
+        // Counters outlive their thread, so snapshot() still includes threads that have exited. The counters
+        // of an exited thread are handed to the next thread that formats the same (type, spec), so the
+        // registry grows with the number of concurrent threads, not with every thread ever started.
+        inline auto register_stats_counters(std::string_view type, uint32_t spec_bits) -> StatsCounters*
+        {
+            auto& registry{ stats_registry() };
+            const std::scoped_lock lock{ registry.mutex };
+            for (const auto& counters : registry.counters) {
+                if (!counters->in_use && counters->type == type && counters->spec_bits == spec_bits) {
+                    counters->in_use = true;
+                    return counters.get();
+                }
+            }
+            auto& counters{ registry.counters.emplace_back(std::make_unique<StatsCounters>()) };
+            counters->type = type;
+            counters->spec_bits = spec_bits;
+            return counters.get();
+        }
+
+        // The counters of one type on one thread, released for reuse when the thread exits.
+        struct ThreadStatsCounters
+        {
+            std::array<StatsCounters*, 1UZ << NUM_FMT_SPECS> entries{};
+
+            ThreadStatsCounters() = default;
+            ThreadStatsCounters(const ThreadStatsCounters&) = delete;
+            ThreadStatsCounters(ThreadStatsCounters&&) = delete;
+            auto operator=(const ThreadStatsCounters&) -> ThreadStatsCounters& = delete;
+            auto operator=(ThreadStatsCounters&&) -> ThreadStatsCounters& = delete;
+
+            ~ThreadStatsCounters()
+            {
+                auto& registry{ stats_registry() };
+                const std::scoped_lock lock{ registry.mutex };
+                for (auto* counters : entries) {
+                    if (counters != nullptr) {
+                        counters->in_use = false;
+                    }
+                }
+            }
+        };
+
+        template<typename T>
+        auto thread_stats_counters(uint32_t spec_bits) -> StatsCounters&
+        {
+            thread_local ThreadStatsCounters counters{};
+            auto*& entry{ counters.entries[spec_bits] };
+            if (entry == nullptr) {
+                entry = register_stats_counters(type_name<T>(), spec_bits);
+            }
+            return *entry;
+        }
+
+        inline auto add_relaxed(std::atomic<uint64_t>& counter, uint64_t value) -> void
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        constexpr auto spec_bits(const FmtOpts& fmt_opts) -> uint32_t
+        {
+            auto bits{ 0U };
+            auto bit{ 0U };
+            for (const auto& [spec, opt] : FMT_SPECS_TO_OPTS) {
+                bits |= fmt_opts.*opt ? 1U << bit : 0U;
+                ++bit;
+            }
+            return bits;
+        }
+
+        constexpr auto spec_chars(uint32_t bits) -> FixedVector<char, NUM_FMT_SPECS>
+        {
+            FixedVector<char, NUM_FMT_SPECS> chars{};
+            auto bit{ 0U };
+            for (const auto& [spec, opt] : FMT_SPECS_TO_OPTS) {
+                if ((bits & (1U << bit++)) != 0U) {
+                    chars.add(std::to_underlying(spec));
+                }
+            }
+            return chars;
+        }
+
+        // Set right before an instrumented formatter re-enters itself to capture its own output.
+        inline auto stats_bypass() -> bool&
+        {
+            thread_local bool bypass{ false };
+            return bypass;
+        }
+
+        // One capture buffer per nesting level, a deque keeps outer buffers in place while it grows.
+        inline auto stats_capture_buffer(size_t depth) -> std::string&
+        {
+            thread_local std::deque<std::string> buffers{};
+            while (buffers.size() <= depth) {
+                buffers.emplace_back();
+            }
+            return buffers[depth];
+        }
+
+        inline auto stats_capture_depth() -> size_t&
+        {
+            thread_local size_t depth{ 0UZ };
+            return depth;
+        }
+#endif
+
+        // Runs a formatter body. With FMTU_ENABLE_STATS the body is timed and its output is captured to
+        // count the emitted bytes, which adds one copy per call; without it this is just impl().
+        template<typename T, typename Ctx, typename Impl>
+        auto instrumented_format([[maybe_unused]] const T& t,
+                                 Ctx& ctx,
+                                 [[maybe_unused]] const FmtOpts& fmt_opts,
+                                 const Impl& impl) -> Ctx::iterator
+        {
+#ifdef FMTU_ENABLE_STATS
+            if (std::exchange(stats_bypass(), false)) {
+                return impl();
+            }
+
+            const auto bits{ spec_bits(fmt_opts) };
+            const auto chars{ spec_chars(bits) };
+            const SpecPattern pattern{ std::string_view{ chars.data.data(), chars.size } };
+
+            auto& depth{ stats_capture_depth() };
+            auto& buffer{ stats_capture_buffer(depth) };
+            buffer.clear();
+
+            const auto start{ std::chrono::steady_clock::now() };
+            {
+                struct Restore
+                {
+                    size_t& depth;
+                    ~Restore()
+                    {
+                        --depth;
+                        stats_bypass() = false;
+                    }
+                } restore{ ++depth };
+                stats_bypass() = true;
+                std::vformat_to(std::back_inserter(buffer), pattern.view(), std::make_format_args(t));
+            }
+            const auto elapsed{ std::chrono::steady_clock::now() - start };
+            const auto ns{ static_cast<uint64_t>(std::chrono::nanoseconds{ elapsed }.count()) };
+
+            auto& counters{ thread_stats_counters<T>(bits) };
+            add_relaxed(counters.calls, 1);
+            add_relaxed(counters.bytes, buffer.size());
+            const auto bucket{ std::min<size_t>(std::bit_width(ns), NUM_LATENCY_BUCKETS - 1) };
+            add_relaxed(counters.latency_ns[bucket], 1);
+            return write_text(ctx.out(), buffer);
+#else
+            return impl();
+#endif
+        }
+
+        // ---------- Size Estimation ----------
+
+        struct SizeCounter
+        {
+            using value_type = char; // NOLINT(readability-identifier-naming)
+            size_t size{ 0UZ };
+
+            constexpr auto push_back(char /*unused*/) -> void { ++size; }
+        };
+    }
+
+    // Bounds of the formatted size of a value, upper is std::nullopt if the size is unbounded.
+    struct SizeHint
+    {
+        size_t lower{ 0UZ };
+        std::optional<size_t> upper{};
+
+        constexpr auto operator==(const SizeHint&) const -> bool = default;
+    };
+
+    namespace detail
+    {
+        constexpr auto add_size_hints(SizeHint a, SizeHint b) -> SizeHint
+        {
+            return { .lower = a.lower + b.lower,
+                     .upper = a.upper && b.upper ? std::optional{ *a.upper + *b.upper } : std::nullopt };
+        }
+
+        template<typename T>
+        consteval auto value_size_hint() -> SizeHint;
+
+        // Literal text of the flattened compact pattern plus the bounds of every leaf member.
+        template<FormatInfo Info>
+        consteval auto class_size_hint() -> SizeHint
+        {
+            constexpr auto fmt{ CLASS_FORMAT<Info> };
+            using Leaves = decltype(make_flat_args_tuple(std::declval<const typename Info::Type&>()));
+
+            return [&]<size_t... Is>(std::index_sequence<Is...>) -> SizeHint {
+                auto hint{ SizeHint{ .lower = CompiledFormat<fmt>::SIZES.first,
+                                     .upper = CompiledFormat<fmt>::SIZES.first } };
+                ((hint = add_size_hints(hint, value_size_hint<std::tuple_element_t<Is, Leaves>>())), ...);
+                return hint;
+            }(std::make_index_sequence<std::tuple_size_v<Leaves>>{});
+        }
+
+        template<typename T>
+        consteval auto value_size_hint() -> SizeHint
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr ((HasAdapter<Type> || Reflectable<Type>) && !ClassFormatted<Type>) {
+                return {};
+            }
+            else if constexpr (HasAdapter<Type>) {
+                return class_size_hint<AdapterInfo<Type>>();
+            }
+            else if constexpr (Reflectable<Type>) {
+                return class_size_hint<ReflectableInfo<Type>>();
+            }
+            else if constexpr (std::same_as<Type, bool>) {
+                return { .lower = 4, .upper = 5 };
+            }
+            else if constexpr (std::same_as<Type, char>) {
+                return { .lower = 1, .upper = 1 };
+            }
+            else if constexpr (std::integral<Type>) {
+                constexpr auto digits{ static_cast<size_t>(std::numeric_limits<Type>::digits10) + 1 };
+                return { .lower = 1, .upper = digits + (std::is_signed_v<Type> ? 1 : 0) };
+            }
+            else if constexpr (std::same_as<Type, float> || std::same_as<Type, double>) {
+                // Shortest round-trip form, never longer than "-d.<max_digits10 - 1>e-XX(X)".
+                constexpr auto exponent_digits{ std::numeric_limits<Type>::max_exponent10 >= 100 ? 3UZ
+                                                                                                 : 2UZ };
+                constexpr auto digits{ static_cast<size_t>(std::numeric_limits<Type>::max_digits10) };
+                return { .lower = 1, .upper = 1 + digits + 1 + 2 + exponent_digits };
+            }
+            else if constexpr (ScopedEnum<Type>) {
+                auto hint{ SizeHint{ .lower = std::numeric_limits<size_t>::max(), .upper = 0UZ } };
+                for (auto e : enumerators<Type>()) {
+                    hint.lower = std::min(hint.lower, enum_name(e).size());
+                    hint.upper = std::max(*hint.upper, enum_name(e).size());
+                }
+                return hint;
+            }
+            else if constexpr (is_optional<Type>::value) {
+                constexpr auto value{ value_size_hint<typename Type::value_type>() };
+                constexpr auto null_size{ std::size("[ null ]"sv) };
+                constexpr auto wrapper_size{ std::size("[  ]"sv) };
+                return { .lower = std::min(null_size, value.lower + wrapper_size),
+                         .upper = value.upper
+                                    ? std::optional{ std::max(null_size, *value.upper + wrapper_size) }
+                                    : std::nullopt };
+            }
+            else if constexpr (is_array<Type>::value) {
+                if constexpr (std::same_as<typename Type::value_type, char>) {
+                    return {};
+                }
+                else {
+                    constexpr auto n{ std::tuple_size_v<Type> };
+                    constexpr auto value{ value_size_hint<typename Type::value_type>() };
+                    constexpr auto separators{ std::size("[]"sv) +
+                                               (n > 0 ? (n - 1) * std::size(", "sv) : 0UZ) };
+                    return { .lower = separators + n * value.lower,
+                             .upper =
+                               value.upper ? std::optional{ separators + n * *value.upper } : std::nullopt };
+                }
+            }
+            else if constexpr (std::is_array_v<Type> && std::same_as<std::remove_extent_t<Type>, char>) {
+                return { .lower = 0, .upper = std::extent_v<Type> };
+            }
+            else {
+                return {};
+            }
+        }
+
+        // ---------- Fixed Capacity ----------
+
+        template<typename T>
+        consteval auto is_heap_free_formattable() -> bool;
+
+        template<FormatInfo Info>
+        consteval auto is_info_heap_free() -> bool
+        {
+            using MemberTypes = typename Info::MemberTypes;
+            return []<size_t... Is>(std::index_sequence<Is...>) -> bool {
+                return (is_heap_free_formattable<std::tuple_element_t<Is, MemberTypes>>() && ...);
+            }(std::make_index_sequence<Info::numMembers()>{});
+        }
+
+        // False for types whose formatter builds a std::string (to_string()/toString()/append_to()) or goes
+        // through an std::ostream, at any nesting depth. The shared stream allocates when it is created and
+        // when its locale is set, a nested operator<< constructs a stream of its own, and operator<< itself
+        // is free to allocate.
+        template<typename T>
+        consteval auto is_heap_free_formattable() -> bool
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr ((HasAdapter<Type> || Reflectable<Type>) && !ClassFormatted<Type>) {
+                return true;
+            }
+            else if constexpr (HasAdapter<Type>) {
+                return is_info_heap_free<AdapterInfo<Type>>();
+            }
+            else if constexpr (Reflectable<Type>) {
+                return is_info_heap_free<ReflectableInfo<Type>>();
+            }
+            else if constexpr (is_optional<Type>::value) {
+                return is_heap_free_formattable<typename Type::value_type>();
+            }
+            else if constexpr (SmartPtr<Type>) {
+                return is_heap_free_formattable<typename Type::element_type>();
+            }
+            else if constexpr (ValuePtr<Type>) {
+                return is_heap_free_formattable<std::remove_pointer_t<Type>>();
+            }
+            else if constexpr (std::ranges::input_range<Type>) {
+                return is_heap_free_formattable<std::ranges::range_value_t<Type>>();
+            }
+            else if constexpr (Streamable<Type>) {
+                return false;
+            }
+            else if constexpr (HasToString<Type>) {
+                return HasFormatTo<Type>;
+            }
+            else {
+                return true;
+            }
+        }
+
+        template<typename T>
+        concept HeapFreeFormattable = is_heap_free_formattable<T>();
+
+        // True if formatting T can reach a class formatter, directly or through optionals, pointers and
+        // ranges, whose formatters forward their spec to the element.
+        template<typename T>
+        consteval auto reaches_class_formatter() -> bool
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (ClassFormatted<Type>) {
+                return true;
+            }
+            else if constexpr (is_optional<Type>::value) {
+                return reaches_class_formatter<typename Type::value_type>();
+            }
+            else if constexpr (SmartPtr<Type>) {
+                return reaches_class_formatter<typename Type::element_type>();
+            }
+            else if constexpr (ValuePtr<Type>) {
+                return reaches_class_formatter<std::remove_pointer_t<Type>>();
+            }
+            else if constexpr (std::ranges::input_range<Type>) {
+                return reaches_class_formatter<std::ranges::range_value_t<Type>>();
+            }
+            else {
+                return false;
+            }
+        }
+
+        // Lower bound of the output of a format string, counting literal text and the compact size hint of
+        // every "{}" / "{n}" field. Throws for serialization specs that reach a class, since they need a heap
+        // buffer.
+        template<typename... Args>
+        consteval auto fixed_format_min_size(std::string_view pattern) -> size_t
+        {
+            constexpr std::array<size_t, sizeof...(Args)> lower_bounds{ value_size_hint<Args>().lower... };
+            constexpr std::array<bool, sizeof...(Args)> is_class{ reaches_class_formatter<Args>()... };
+
+            auto size{ 0UZ };
+            auto next_arg{ 0UZ };
+            for (auto i{ 0UZ }; i < pattern.size(); ++i) {
+                // The pattern is already validated, so any other brace is the first of an escaped pair.
+                const auto is_field{ pattern[i] == '{' && pattern[i + 1] != '{' };
+                if (!is_field) {
+                    i += pattern[i] == '{' || pattern[i] == '}' ? 1 : 0;
+                    ++size;
+                    continue;
+                }
+
+                const auto close{ pattern.find('}', i) };
+                const auto field{ pattern.substr(i + 1, close - i - 1) };
+                if (field.contains('{')) {
+                    return size; // Dynamic width or precision, stop with the bound collected so far.
+                }
+                const auto colon{ field.find(':') };
+                const auto id{ field.substr(0, colon) };
+                const auto spec{ colon == std::string_view::npos ? ""sv : field.substr(colon + 1) };
+
+                auto arg{ next_arg++ };
+                if (!id.empty()) {
+                    arg = 0;
+                    for (auto c : id) {
+                        arg = arg * 10 + static_cast<size_t>(c - '0');
+                    }
+                }
+
+                if (spec.empty()) {
+                    size += lower_bounds[arg];
+                }
+                else if (is_class[arg] && spec.find_first_of("jytb") != std::string_view::npos) {
+                    throw std::format_error("Serialization specs need a heap buffer and are not supported by "
+                                            "format_to_fixed");
+                }
+                i = close;
+            }
+            return size;
+        }
+    }
+
+    // Compile-time bounds of the compact "{}" output of T. The upper bound is exact for classes whose
+    // leaf members are all bounded (integers, bools, chars, floats, enums and fixed arrays of those).
+    template<typename T>
+    consteval auto formatted_size_hint() -> SizeHint
+    {
+        return detail::value_size_hint<T>();
+    }
+
+    // Exact size of formatting value with the given spec (e.g. "p" or "pj") without allocating.
+    template<typename T>
+    auto formatted_size(const T& value, std::string_view spec = {}) -> size_t
+    {
+        const detail::SpecPattern pattern{ spec };
+        detail::SizeCounter counter{};
+        std::vformat_to(std::back_inserter(counter), pattern.view(), std::make_format_args(value));
+        return counter.size;
+    }
+
+    // Inline string returned by format_to_fixed, holding at most N characters.
+    template<size_t N>
+    struct FixedString
+    {
+        detail::FixedVector<char, N> chars{};
+        bool truncated{ false };
+
+        constexpr auto view() const -> std::string_view { return { chars.data.data(), chars.size }; }
+        constexpr auto size() const -> size_t { return chars.size; }
+        constexpr operator std::string_view() const { return view(); } // NOLINT(google-explicit-constructor)
+    };
+
+    // Format string of format_to_fixed, checked at compile time like std::format_string. It is rejected if
+    // the size hints prove the output never fits into N characters or if it asks a class for JSON, YAML,
+    // TOML or BEVE output.
+    template<size_t N, typename... Args>
+    struct FixedFormatString
+    {
+        std::format_string<Args...> fmt;
+
+        template<typename S>
+            requires std::convertible_to<const S&, std::string_view>
+        consteval FixedFormatString(const S& pattern) // NOLINT(google-explicit-constructor)
+          : fmt{ pattern }
+        {
+            if (detail::fixed_format_min_size<Args...>(pattern) > N) {
+                throw std::format_error("Output never fits into the capacity of format_to_fixed");
+            }
+        }
+    };
+
+    // Formats into an inline buffer of N characters without touching the heap, meant for threads that
+    // must not allocate. Output beyond N characters is cut off at byte N and flagged as truncated. Types
+    // whose formatting may allocate (to_string()/toString()/append_to()/operator<< at any depth) are
+    // rejected.
+    template<size_t N, typename... Args>
+        requires(detail::HeapFreeFormattable<Args> && ...)
+    auto format_to_fixed(FixedFormatString<N, std::type_identity_t<Args>...> fmt, Args&&... args)
+      -> FixedString<N>
+    {
+        FixedString<N> result{};
+        const auto [out, size] = std::format_to_n(result.chars.data.data(),
+                                                  static_cast<std::ptrdiff_t>(N),
+                                                  fmt.fmt,
+                                                  std::forward<Args>(args)...);
+        result.chars.size = static_cast<size_t>(out - result.chars.data.data());
+        result.truncated = std::cmp_greater(size, N);
+        return result;
+    }
+
+    // Pair of snapshots of the same class, formatting it only emits the members that changed between them
+    // as "path: old -> new" with dotted paths into nested classes, separated by ", " or by newlines with
+    // "{:p}". Both snapshots must outlive the Diff.
+    template<typename T>
+        requires(detail::HasAdapter<T> || detail::Reflectable<T>)
+    class Diff
+    {
+      public:
+        constexpr Diff(const T& old_value, const T& new_value)
+          : m_old{ &old_value }
+          , m_new{ &new_value }
+        {
+        }
+
+        constexpr auto old_value() const -> const T& { return *m_old; }
+        constexpr auto new_value() const -> const T& { return *m_new; }
+
+      private:
+        const T* m_old;
+        const T* m_new;
+    };
+
+    template<typename T>
+    constexpr auto diff(const T& old_value, const T& new_value) -> Diff<T>
+    {
+        return { old_value, new_value };
+    }
+
+    template<typename T>
+    auto format_diff(const T& old_value, const T& new_value) -> std::string
+    {
+        return std::format("{}", Diff<T>{ old_value, new_value });
+    }
+
+    // View formatting only the named members of a class, in the listed order. Unknown names fail to compile.
+    template<typename T, reflect::fixed_string... Names>
+        requires(detail::HasAdapter<T> || detail::Reflectable<T>)
+    class Projection
+    {
+      public:
+        explicit constexpr Projection(const T& value)
+          : m_value{ &value }
+        {
+        }
+
+        constexpr auto value() const -> const T& { return *m_value; }
+
+      private:
+        const T* m_value;
+    };
+
+    // fmtu::project<"id", "name">(cfg) formats as "[ Config: { id: 1, name: main } ]", or pretty with "{:p}".
+    template<reflect::fixed_string... Names, typename T>
+        requires(sizeof...(Names) > 0)
+    constexpr auto project(const T& value) -> Projection<T, Names...>
+    {
+        return Projection<T, Names...>{ value };
+    }
+
+    // Owns a value and memoizes its formatted output per format spec, keyed by a content hash over all
+    // members. Formatting a Cached<T> hashes the value and, if the output for that spec was produced for
+    // the same hash, only copies the stored string; otherwise it formats and publishes the new output.
+    // Const access (including formatting) is thread-safe and readers never lock, a miss takes a mutex to
+    // publish. Replaced outputs stay alive until no format call is in flight, or until the next non-const
+    // call, which must not run concurrently with formatting like any other mutation of the value. While
+    // MAX_RETIRED outputs wait to be freed, misses format without caching, so memory stays bounded even if
+    // the hash keeps changing without modify() (adapter getters reading external state, pointees).
+    template<typename T>
+        requires std::formattable<T, char> && detail::ContentHashable<T>
+    class Cached
+    {
+      public:
+        static constexpr size_t MAX_SPECS{ 8 };
+        static constexpr size_t MAX_RETIRED{ 16 };
+
+        Cached() = default;
+
+        explicit Cached(T value)
+          : m_value{ std::move(value) }
+        {
+        }
+
+        Cached(const Cached&) = delete;
+        Cached(Cached&&) = delete;
+        auto operator=(const Cached&) -> Cached& = delete;
+        auto operator=(Cached&&) -> Cached& = delete;
+
+        ~Cached()
+        {
+            for (auto& slot : m_slots) {
+                delete slot.load(std::memory_order_relaxed); // NOLINT(cppcoreguidelines-owning-memory)
+            }
+        }
+
+        auto value() const -> const T& { return m_value; }
+
+        // Number of outputs kept alive, the published ones plus the replaced ones not yet freed.
+        auto retained_entries() const -> size_t
+        {
+            const std::scoped_lock lock{ m_mutex };
+            const auto published{ std::ranges::count_if(m_slots, [](const auto& slot) -> bool {
+                return slot.load(std::memory_order_relaxed) != nullptr;
+            }) };
+            return static_cast<size_t>(published) + m_retired.size();
+        }
+
+        // Mutable access, the next format notices the changed content through its hash.
+        auto modify() -> T&
+        {
+            m_retired.clear();
+            return m_value;
+        }
+
+        template<typename OutIt>
+        auto format_to(OutIt out, std::string_view spec) const -> OutIt
+        {
+            const ReaderScope reader{ *this };
+            const auto hash{ detail::content_hash(m_value) };
+
+            auto* free_slot{ static_cast<std::atomic<const Entry*>*>(nullptr) };
+            for (auto& slot : m_slots) {
+                const auto* entry{ slot.load(std::memory_order_acquire) };
+                if (entry == nullptr) {
+                    free_slot = free_slot != nullptr ? free_slot : &slot;
+                    continue;
+                }
+                if (entry->spec == spec) {
+                    if (entry->hash == hash) {
+                        return detail::write_text(std::move(out), entry->output);
+                    }
+                    return publish(std::move(out), spec, hash, &slot);
+                }
+            }
+            return publish(std::move(out), spec, hash, free_slot);
+        }
+
+      private:
+        struct Entry
+        {
+            std::string spec;
+            size_t hash;
+            std::string output;
+        };
+
+        // A reader may still use an entry it loaded before the entry was retired. Retired entries are freed
+        // once no reader is in flight; a reader that starts afterwards only sees the published entries.
+        struct ReaderScope
+        {
+            const Cached& self;
+
+            explicit ReaderScope(const Cached& cached)
+              : self{ cached }
+            {
+                self.m_readers.fetch_add(1);
+            }
+
+            ReaderScope(const ReaderScope&) = delete;
+            ReaderScope(ReaderScope&&) = delete;
+            auto operator=(const ReaderScope&) -> ReaderScope& = delete;
+            auto operator=(ReaderScope&&) -> ReaderScope& = delete;
+
+            ~ReaderScope()
+            {
+                if (self.m_readers.fetch_sub(1) != 1) {
+                    return;
+                }
+                const std::scoped_lock lock{ self.m_mutex };
+                if (self.m_readers.load() == 0) {
+                    self.m_retired.clear();
+                }
+            }
+        };
+
+        template<typename OutIt>
+        auto publish(OutIt out, std::string_view spec, size_t hash, std::atomic<const Entry*>* slot) const
+          -> OutIt
+        {
+            const detail::SpecPattern pattern{ spec };
+            auto entry{ std::make_unique<Entry>(Entry{ std::string{ spec }, hash, {} }) };
+            auto& output{ entry->output };
+            std::vformat_to(std::back_inserter(output), pattern.view(), std::make_format_args(m_value));
+            out = detail::write_text(std::move(out), output);
+            if (slot == nullptr) {
+                return out; // Every slot is taken by another spec, the output is not cached.
+            }
+
+            const std::scoped_lock lock{ m_mutex };
+            const auto* current{ slot->load(std::memory_order_relaxed) };
+            if (current != nullptr && current->spec != spec) {
+                return out; // The free slot was claimed for another spec in the meantime.
+            }
+            if (current != nullptr && m_retired.size() >= MAX_RETIRED) {
+                return out; // Readers keep the retired outputs alive, don't retire another one.
+            }
+            slot->store(entry.release(), std::memory_order_release);
+            if (current != nullptr) {
+                m_retired.emplace_back(current);
+            }
+            return out;
+        }
+
+        T m_value{};
+        mutable std::array<std::atomic<const Entry*>, MAX_SPECS> m_slots{};
+        mutable std::vector<std::unique_ptr<const Entry>> m_retired{};
+        mutable std::atomic<size_t> m_readers{ 0 };
+        mutable std::mutex m_mutex{};
+    };
+
+#ifdef FMTU_ENABLE_STATS
+    namespace stats
+    {
+        // Formatting statistics of one type and format spec, summed over all threads.
+        struct TypeStats
+        {
+            std::string_view type{};
+            std::string spec{};
+            uint64_t calls{ 0 };
+            uint64_t bytes{ 0 };
+            // latency_ns[i] counts calls that took less than 2^i ns (and at least 2^(i-1) ns).
+            std::array<uint64_t, detail::NUM_LATENCY_BUCKETS> latency_ns{};
+        };
+
+        // Reads the per-thread counters of every instrumented formatter without pausing the writers.
+        inline auto snapshot() -> std::vector<TypeStats>
+        {
+            auto& registry{ detail::stats_registry() };
+            const std::scoped_lock lock{ registry.mutex };
+
+            std::vector<TypeStats> result{};
+            for (const auto& counters : registry.counters) {
+                const auto chars{ detail::spec_chars(counters->spec_bits) };
+                const std::string_view spec{ chars.data.data(), chars.size };
+                auto it{ std::ranges::find_if(result, [&](const TypeStats& stats) -> bool {
+                    return stats.type == counters->type && stats.spec == spec;
+                }) };
+                if (it == result.end()) {
+                    it = result.insert(result.end(),
+                                       TypeStats{ .type = counters->type, .spec = std::string{ spec } });
+                }
+
+                it->calls += counters->calls.load(std::memory_order_relaxed);
+                it->bytes += counters->bytes.load(std::memory_order_relaxed);
+                for (auto i{ 0UZ }; i < detail::NUM_LATENCY_BUCKETS; ++i) {
+                    it->latency_ns[i] += counters->latency_ns[i].load(std::memory_order_relaxed);
+                }
+            }
+            return result;
+        }
+    }
+#endif
+
+    // Formats into a string allocated from resource. Internal temporaries (the serialization buffer of the
+    // JSON/YAML/TOML/BEVE paths) are allocated from the same resource, so a per-request arena such as
+    // std::pmr::monotonic_buffer_resource absorbs every allocation of the call.
+    template<typename... Args>
+    auto format(std::pmr::memory_resource* resource, std::format_string<Args...> fmt, Args&&... args)
+      -> std::pmr::string
+    {
+        const detail::ResourceScope scope{ resource };
+        std::pmr::string result{ resource };
+        std::format_to(std::back_inserter(result), fmt, std::forward<Args>(args)...);
+        return result;
+    }
+
+    // Formats the elements of a large range with the given spec (e.g. "p" or "j") on up to num_threads
+    // threads and joins them in order with separator. The range is split into one contiguous chunk per
+    // thread, each formatted into its own buffer, so the output is identical to a sequential join.
+    template<std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<Range> &&
+                 std::formattable<std::ranges::range_value_t<Range>, char>
+    auto format_range_parallel(const Range& range,
+                               std::string_view spec = {},
+                               std::string_view separator = ", ",
+                               size_t num_threads = std::thread::hardware_concurrency()) -> std::string
+    {
+        // Below this many elements per chunk, spawning a thread costs more than it saves.
+        static constexpr size_t MIN_CHUNK_SIZE{ 256 };
+
+        const detail::SpecPattern pattern{ spec };
+        const auto size{ static_cast<size_t>(std::ranges::size(range)) };
+        const auto num_chunks{ std::clamp(size / MIN_CHUNK_SIZE, 1UZ, std::max(num_threads, 1UZ)) };
+
+        const auto chunk_begin = [&](size_t chunk) -> size_t { return chunk * size / num_chunks; };
+
+        const auto format_chunk = [&](size_t chunk, std::string& out) {
+            const auto first{ chunk_begin(chunk) };
+            const auto last{ chunk_begin(chunk + 1) };
+            auto it{ std::back_inserter(out) };
+            for (auto i{ first }; i < last; ++i) {
+                if (i != first) {
+                    it = std::ranges::copy(separator, it).out;
+                }
+                const auto& value{ std::ranges::begin(range)[static_cast<std::ptrdiff_t>(i)] };
+                it = std::vformat_to(it, pattern.view(), std::make_format_args(value));
+            }
+        };
+
+        std::vector<std::string> buffers(num_chunks);
+        std::vector<std::exception_ptr> errors(num_chunks);
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(num_chunks - 1);
+            for (auto chunk{ 1UZ }; chunk < num_chunks; ++chunk) {
+                workers.emplace_back([&, chunk] {
+                    try {
+                        format_chunk(chunk, buffers[chunk]);
+                    }
+                    catch (...) {
+                        errors[chunk] = std::current_exception();
+                    }
+                });
+            }
+            try {
+                format_chunk(0, buffers[0]);
+            }
+            catch (...) {
+                errors[0] = std::current_exception();
             }
         }
 
-        template<typename T>
-        struct GlazeAdapter
-        {
-            using Fields = typename Adapter<T>::Fields;
-            // NOLINTNEXTLINE(readability-identifier-naming)
-            static constexpr auto value = []<size_t... Is>(std::index_sequence<Is...>) -> auto {
-                return std::apply(
-                  [](auto&&... args) -> auto { return glz::object(std::forward<decltype(args)>(args)...); },
-                  std::tuple_cat(std::make_tuple(std::tuple_element_t<Is, Fields>::NAME,
-                                                 glaze_field_value<std::tuple_element_t<Is, Fields>>())...));
-            }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
-        };
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
 
-        template<typename T>
-        concept HasGlazeMeta = requires { glz::meta<std::remove_cvref_t<T>>::value; };
-#endif
+        auto total{ num_chunks > 1 ? (num_chunks - 1) * separator.size() : 0UZ };
+        for (const auto& buffer : buffers) {
+            total += buffer.size();
+        }
+        std::string result;
+        result.reserve(total);
+        for (auto chunk{ 0UZ }; chunk < num_chunks; ++chunk) {
+            // Decided by element count, not by the buffer: elements may format to an empty string.
+            if (chunk != 0 && chunk_begin(chunk + 1) > chunk_begin(chunk)) {
+                result.append(separator);
+            }
+            result.append(buffers[chunk]);
+        }
+        return result;
+    }
 
-        // ---------- Format Opts ----------
+    // Bounded lock-free multi-producer queue that defers formatting to a consumer thread. Producers only
+    // pay for copying the object into a preallocated slot (a memcpy for trivially copyable types) and two
+    // atomic operations, the consumer later runs the regular std::formatter<T>. Each producer's objects
+    // are consumed in the order they were pushed.
+    template<typename T, size_t Capacity>
+        requires std::copy_constructible<T> && std::formattable<T, char>
+    class DeferredQueue
+    {
+        static_assert(Capacity >= 2 && std::has_single_bit(Capacity), "Capacity must be a power of two");
 
-        struct FmtOpts
+      public:
+        DeferredQueue()
         {
-            bool verbose;
-            bool pretty;
-            bool json;
-            bool yaml;
-            bool toml;
-
-            constexpr auto operator==(const FmtOpts&) const -> bool = default;
-            constexpr operator bool(this const auto& self) { return self != FmtOpts{}; }
-        };
+            for (auto i{ 0UZ }; i < Capacity; ++i) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
 
-        // clang-format off
-        static constexpr FixedMap<FmtSpecs, bool FmtOpts::*, NUM_FMT_SPECS> FMT_SPECS_TO_OPTS{std::array{ 
-            std::make_pair(FmtSpecs::Verbose,   &FmtOpts::verbose),
-            std::make_pair(FmtSpecs::Pretty,    &FmtOpts::pretty),
-            std::make_pair(FmtSpecs::Json,      &FmtOpts::json),
-            std::make_pair(FmtSpecs::Yaml,      &FmtOpts::yaml),
-            std::make_pair(FmtSpecs::Toml,      &FmtOpts::toml) 
-        }};
-        // clang-format on
+        DeferredQueue(const DeferredQueue&) = delete;
+        DeferredQueue(DeferredQueue&&) = delete;
+        auto operator=(const DeferredQueue&) -> DeferredQueue& = delete;
+        auto operator=(DeferredQueue&&) -> DeferredQueue& = delete;
 
-        template<FmtOpts AllowedOpts, typename Ctx>
-        constexpr auto parse_fmt_opts(Ctx& ctx, FmtOpts& active_opts) -> Ctx::iterator
+        ~DeferredQueue()
         {
-            auto it{ ctx.begin() };
+            while (pop()) {
+            }
+        }
 
-            std::vector<FmtSpecs> incompatibel_specs{};
-            while (it != ctx.end()) {
-                auto spec_char{ *it };
-                if (spec_char == '}') {
-                    return it;
+        // Returns false without blocking if the queue is full.
+        auto push(const T& value) -> bool
+        {
+            auto pos{ m_enqueue_pos.load(std::memory_order_relaxed) };
+            for (;;) {
+                auto& cell{ m_cells[pos & (Capacity - 1)] };
+                const auto sequence{ cell.sequence.load(std::memory_order_acquire) };
+                const auto diff{ static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos) };
+                if (diff == 0) {
+                    if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        construct(cell, pos, value);
+                        return true;
+                    }
                 }
-
-                auto spec{ static_cast<FmtSpecs>(spec_char) };
-                if (std::ranges::contains(incompatibel_specs, spec)) {
-                    throw std::format_error("Invalid format specifier");
+                else if (diff < 0) {
+                    return false;
                 }
-
-                auto opt{ FMT_SPECS_TO_OPTS.at(spec) };
-                if (!opt.has_value() || !(AllowedOpts.*opt.value())) {
-                    throw std::format_error("Invalid format specifier");
+                else {
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
                 }
-                active_opts.*opt.value() = true;
+            }
+        }
 
-                if (auto inc_specs{ FMT_INCOMPATIBEL_SPECS.at(spec) }; inc_specs.has_value()) {
-                    incompatibel_specs.insert(incompatibel_specs.end(), inc_specs->begin(), inc_specs->end());
+        auto pop() -> std::optional<T>
+        {
+            auto pos{ m_dequeue_pos.load(std::memory_order_relaxed) };
+            for (;;) {
+                auto& cell{ m_cells[pos & (Capacity - 1)] };
+                const auto sequence{ cell.sequence.load(std::memory_order_acquire) };
+                const auto diff{ static_cast<std::ptrdiff_t>(sequence) -
+                                 static_cast<std::ptrdiff_t>(pos + 1) };
+                if (diff == 0) {
+                    if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        if (!cell.engaged) {
+                            cell.sequence.store(pos + Capacity, std::memory_order_release);
+                            pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                            continue;
+                        }
+                        // The cell is released even if the move throws, the value is then dropped.
+                        struct Release
+                        {
+                            Cell& cell;
+                            size_t sequence;
+                            ~Release()
+                            {
+                                std::destroy_at(cell.value());
+                                cell.sequence.store(sequence, std::memory_order_release);
+                            }
+                        } release{ cell, pos + Capacity };
+                        return std::optional<T>{ std::move(*cell.value()) };
+                    }
+                }
+                else if (diff < 0) {
+                    return std::nullopt;
+                }
+                else {
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
                 }
-
-                ++it;
             }
+        }
 
-            return it;
+        // Formats every queued object in FIFO order, meant to be called from the consumer thread.
+        template<typename OutIt>
+        auto drain(OutIt out, std::format_string<const T&> fmt = "{}\n") -> OutIt
+        {
+            while (auto value{ pop() }) {
+                out = std::format_to(std::move(out), fmt, std::as_const(*value));
+            }
+            return out;
         }
 
-        template<FormatInfo Info, typename Ctx, typename T>
-        auto handle_class_opts(Ctx& ctx, const T& t, const FmtOpts& fmt_opts)
-          -> std::optional<typename Ctx::iterator>
+      private:
+        struct Cell
         {
-#ifdef FMTU_ENABLE_JSON
-            if (fmt_opts.json) {
-                if constexpr (GlazeSerializable<T, GlazeFormat::Json>) {
+            std::atomic<size_t> sequence{};
+            bool engaged{ false };
+            alignas(T) std::array<std::byte, sizeof(T)> storage{};
 
-                    auto json_str{ (fmt_opts.pretty ? glz::write<glz::opts{ .prettify = true }>(t)
-                                                    : glz::write_json(t))
-                                     .value_or("JSON Error") };
-                    return std::format_to(ctx.out(), "{}", json_str);
+            auto value() -> T* { return std::launder(reinterpret_cast<T*>(storage.data())); }
+        };
+
+        // The slot is already claimed when the copy is made. If the copy constructor throws, the slot is
+        // published as an empty tombstone that pop() skips, so consumers do not wait on it forever.
+        static auto construct(Cell& cell, size_t pos, const T& value) -> void
+        {
+            if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+                std::construct_at(cell.value(), value);
+                cell.engaged = true;
+            }
+            else {
+                try {
+                    std::construct_at(cell.value(), value);
+                    cell.engaged = true;
                 }
-                else {
-                    throw std::format_error("Failed to format json");
+                catch (...) {
+                    cell.engaged = false;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    throw;
                 }
             }
-#endif
-#ifdef FMTU_ENABLE_YAML
-            if (fmt_opts.yaml) {
-                if constexpr (GlazeSerializable<T, GlazeFormat::Yaml> && HasGlazeMeta<T>) {
+            cell.sequence.store(pos + 1, std::memory_order_release);
+        }
 
-                    auto yaml_str{ glz::write_yaml(t).value_or("YAML Error") };
-                    return std::format_to(ctx.out(), "{}", yaml_str);
+        // Producer and consumer positions live on separate cache lines to avoid false sharing.
+        static constexpr size_t CACHE_LINE_SIZE{ 64 };
+
+        alignas(CACHE_LINE_SIZE) std::array<Cell, Capacity> m_cells{};
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueue_pos{ 0 };
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeue_pos{ 0 };
+    };
+
+    namespace detail
+    {
+        // ---------- Class Formatter ----------
+
+        // Shared implementation of the std::formatter specializations for adapted and reflected classes, and
+        // the base of the out-of-line formatters declared by FMTU_DECLARE_FORMATTER.
+        template<typename T>
+            requires HasAdapter<T> || Reflectable<T>
+        struct ClassFormatter
+        {
+            static_assert(
+              HasAdapter<T> || requires { T{}; },
+              "Type T contains reference members or other non-value-initializable members, which are not "
+              "supported for automatic formatting. Consider removing references or providing default "
+              "initializers.");
+
+            using Info = class_info_t<T>;
+
+            // clang-format off
+            static constexpr FmtOpts ALLOWED_FMT_OPTS{
+                .verbose = true,
+                .pretty = true,
+                .json = IS_JSON_ENABLED,
+                .yaml = IS_YAML_ENABLED,
+                .toml = IS_TOML_ENABLED,
+                .beve = IS_BEVE_ENABLED,
+                .sparse = true
+            };
+            // clang-format on
+
+            FmtOpts fmt_opts{};
+
+            template<typename Ctx>
+            constexpr auto parse(Ctx& ctx) -> Ctx::iterator
+            {
+                auto it{ parse_fmt_opts<ALLOWED_FMT_OPTS>(ctx, fmt_opts) };
+#ifdef FMTU_ENABLE_GLAZE
+                if (fmt_opts.json && !GlazeSerializable<T, GlazeFormat::Json>) {
+                    throw std::format_error("Formatting not possible: Json");
                 }
-                else {
-                    throw std::format_error("Failed to format yaml");
+#ifdef FMTU_ENABLE_JSON
+                if (fmt_opts.json && fmt_opts.sparse && !SparseJsonWritable<T>) {
+                    throw std::format_error("Formatting not possible: Json");
                 }
-            }
 #endif
-#ifdef FMTU_ENABLE_TOML
-            if (fmt_opts.toml) {
-                if constexpr (GlazeSerializable<T, GlazeFormat::Toml>) {
-
-                    auto toml_str{ glz::write_toml(t).value_or("TOML Error") };
-                    return std::format_to(ctx.out(), "{}", toml_str);
+                if (fmt_opts.yaml && (!GlazeSerializable<T, GlazeFormat::Yaml> || !HasGlazeMeta<T>)) {
+                    throw std::format_error("Formatting not possible: Yaml");
                 }
-                else {
-                    throw std::format_error("Failed to format toml");
+                if (fmt_opts.toml && !GlazeSerializable<T, GlazeFormat::Toml>) {
+                    throw std::format_error("Formatting not possible: Toml");
+                }
+                if (fmt_opts.beve && !GlazeSerializable<T, GlazeFormat::Beve>) {
+                    throw std::format_error("Formatting not possible: Beve");
                 }
-            }
 #endif
-            if (fmt_opts.pretty) {
-                auto args_tuple{ fmtu::detail::make_flat_args_tuple(t) };
-                static constexpr auto fmt{ fmtu::detail::class_pretty_format<Info>() };
-                return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
-                    return std::format_to(ctx.out(), fmt, args...);
-                }, args_tuple);
+                return it;
             }
 
-            return std::nullopt;
-        }
+            template<typename Ctx>
+            auto format(const T& t, Ctx& ctx) const -> Ctx::iterator
+            {
+                return instrumented_format(t, ctx, fmt_opts, [&] -> Ctx::iterator {
+                    if (fmt_opts) {
+                        if (auto it{ handle_class_opts<Info>(ctx, t, fmt_opts) }; it.has_value()) {
+                            return it.value();
+                        }
+                    }
+
+                    auto args_tuple{ make_flat_args_tuple(t) };
+
+                    static constexpr auto fmt{ CLASS_FORMAT<Info> };
+                    return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
+                        return format_compiled<fmt>(ctx, args...);
+                    }, args_tuple);
+                });
+            }
+        };
     }
 }
 
@@ -940,123 +3131,13 @@ struct glz::meta<T> : fmtu::detail::GlazeAdapter<T>
 #endif
 
 template<fmtu::detail::HasAdapter T>
-struct std::formatter<T>
+struct std::formatter<T> : fmtu::detail::ClassFormatter<T>
 {
-    using Info = fmtu::detail::AdapterInfo<T>;
-
-    // clang-format off
-    static constexpr fmtu::detail::FmtOpts ALLOWED_FMT_OPTS{
-        .verbose = true,
-        .pretty = true,
-        .json = fmtu::IS_JSON_ENABLED,
-        .yaml = fmtu::IS_YAML_ENABLED,
-        .toml = fmtu::IS_TOML_ENABLED
-    };
-    // clang-format on
-
-    fmtu::detail::FmtOpts fmt_opts{};
-
-    template<typename Ctx>
-    constexpr auto parse(Ctx& ctx) -> Ctx::iterator
-    {
-        auto it{ fmtu::detail::parse_fmt_opts<ALLOWED_FMT_OPTS>(ctx, fmt_opts) };
-#ifdef FMTU_ENABLE_GLAZE
-        if (fmt_opts.json && !fmtu::detail::GlazeSerializable<T, fmtu::detail::GlazeFormat::Json>) {
-            throw std::format_error("Formatting not possible: Json");
-        }
-        if (fmt_opts.yaml && (!fmtu::detail::GlazeSerializable<T, fmtu::detail::GlazeFormat::Yaml> ||
-                              !fmtu::detail::HasGlazeMeta<T>)) {
-            throw std::format_error("Formatting not possible: Yaml");
-        }
-        if (fmt_opts.toml && !fmtu::detail::GlazeSerializable<T, fmtu::detail::GlazeFormat::Toml>) {
-            throw std::format_error("Formatting not possible: Toml");
-        }
-#endif
-        return it;
-    }
-
-    template<typename Ctx>
-    auto format(const T& t, Ctx& ctx) const -> Ctx::iterator
-    {
-        if (fmt_opts) {
-            if (auto it{ fmtu::detail::handle_class_opts<Info>(ctx, t, fmt_opts) }; it.has_value()) {
-                return it.value();
-            }
-        }
-
-        auto args_tuple{ [&]<size_t... Is>(std::index_sequence<Is...>) -> auto {
-            using Fields = typename fmtu::Adapter<std::remove_cvref_t<T>>::Fields;
-            return fmtu::detail::make_args_tuple(
-              fmtu::detail::check_arg(std::invoke(std::tuple_element_t<Is, Fields>::VALUE, t))...);
-        }(std::make_index_sequence<Info::numMembers()>{}) };
-
-        static constexpr auto fmt{ fmtu::detail::class_format<Info>() };
-        return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
-            return std::format_to(ctx.out(), fmt, args...);
-        }, args_tuple);
-    }
 };
 
 template<fmtu::detail::Reflectable T>
-struct std::formatter<T>
+struct std::formatter<T> : fmtu::detail::ClassFormatter<T>
 {
-    static_assert(
-      requires { T{}; },
-      "Type T contains reference members or other non-value-initializable members, which are not "
-      "supported "
-      "for automatic formatting. Consider removing references or providing default initializers.");
-
-    using Info = fmtu::detail::ReflectableInfo<T>;
-
-    // clang-format off
-    static constexpr fmtu::detail::FmtOpts ALLOWED_FMT_OPTS{ 
-        .verbose = true,
-        .pretty = true,
-        .json = fmtu::IS_JSON_ENABLED,
-        .yaml = fmtu::IS_YAML_ENABLED,
-        .toml = fmtu::IS_TOML_ENABLED
-    };
-    // clang-format on
-
-    fmtu::detail::FmtOpts fmt_opts{};
-
-    template<typename Ctx>
-    constexpr auto parse(Ctx& ctx) -> Ctx::iterator
-    {
-        auto it{ fmtu::detail::parse_fmt_opts<ALLOWED_FMT_OPTS>(ctx, fmt_opts) };
-#ifdef FMTU_ENABLE_GLAZE
-        if (fmt_opts.json && !fmtu::detail::GlazeSerializable<T, fmtu::detail::GlazeFormat::Json>) {
-            throw std::format_error("Formatting not possible: Json");
-        }
-        if (fmt_opts.yaml && (!fmtu::detail::GlazeSerializable<T, fmtu::detail::GlazeFormat::Yaml> ||
-                              !fmtu::detail::HasGlazeMeta<T>)) {
-            throw std::format_error("Formatting not possible: Yaml");
-        }
-        if (fmt_opts.toml && !fmtu::detail::GlazeSerializable<T, fmtu::detail::GlazeFormat::Toml>) {
-            throw std::format_error("Formatting not possible: Toml");
-        }
-#endif
-        return it;
-    }
-
-    template<typename Ctx>
-    auto format(const T& t, Ctx& ctx) const -> Ctx::iterator
-    {
-        if (fmt_opts) {
-            if (auto it{ fmtu::detail::handle_class_opts<Info>(ctx, t, fmt_opts) }; it.has_value()) {
-                return it.value();
-            }
-        }
-
-        auto args_tuple{ [&]<size_t... Is>(std::index_sequence<Is...>) -> auto {
-            return fmtu::detail::make_args_tuple(fmtu::detail::check_arg(reflect::get<Is>(t))...);
-        }(std::make_index_sequence<reflect::size<T>()>{}) };
-
-        static constexpr auto fmt{ fmtu::detail::class_format<Info>() };
-        return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
-            return std::format_to(ctx.out(), fmt, args...);
-        }, args_tuple);
-    }
 };
 
 template<fmtu::detail::ScopedEnum T>
@@ -1075,10 +3156,14 @@ struct std::formatter<T>
     template<typename Ctx>
     auto format(T t, Ctx& ctx) const -> Ctx::iterator
     {
-        if (fmt_opts.verbose) {
-            return std::format_to(ctx.out(), "{}::{}", fmtu::detail::type_name<T>(), reflect::enum_name(t));
-        }
-        return std::format_to(ctx.out(), "{}", reflect::enum_name(t));
+        return fmtu::detail::instrumented_format(t, ctx, fmt_opts, [&] -> Ctx::iterator {
+            auto out{ ctx.out() };
+            if (fmt_opts.verbose) {
+                out = fmtu::detail::write_text(std::move(out), fmtu::detail::type_name<T>());
+                out = fmtu::detail::write_text(std::move(out), "::"sv);
+            }
+            return fmtu::detail::write_text(std::move(out), fmtu::detail::enum_name(t));
+        });
     }
 };
 
@@ -1140,11 +3225,11 @@ struct std::formatter<T>
     }
 
     template<typename Ctx>
-    auto format(T t, Ctx& ctx) const -> Ctx::iterator
+    auto format(const T& t, Ctx& ctx) const -> Ctx::iterator
     {
-        std::ostringstream oss;
-        oss << t;
-        return std::format_to(ctx.out(), "{}", oss.str());
+        return fmtu::detail::instrumented_format(t, ctx, fmtu::detail::FmtOpts{}, [&] -> Ctx::iterator {
+            return fmtu::detail::write_streamable(ctx.out(), t);
+        });
     }
 };
 
@@ -1160,30 +3245,151 @@ struct std::formatter<T>
     }
 
     template<typename Ctx>
-    auto format(T t, Ctx& ctx) const -> Ctx::iterator
+    auto format(const T& t, Ctx& ctx) const -> Ctx::iterator
     {
-        if constexpr (requires { std::decay_t<decltype(t)>::to_string(); }) {
-            return std::format_to(ctx.out(), "{}", std::decay_t<decltype(t)>::to_string());
-        }
-        else if constexpr (requires { std::decay_t<decltype(t)>::toString(); }) {
-            return std::format_to(ctx.out(), "{}", std::decay_t<decltype(t)>::toString());
-        }
-        else if constexpr (requires { t.to_string(); }) {
-            return std::format_to(ctx.out(), "{}", t.to_string());
-        }
-        else if constexpr (requires { t.toString(); }) {
-            return std::format_to(ctx.out(), "{}", t.toString());
-        }
-        else if constexpr (requires { to_string(t); }) {
-            return std::format_to(ctx.out(), "{}", to_string(t));
+        return fmtu::detail::instrumented_format(t, ctx, fmtu::detail::FmtOpts{}, [&] -> Ctx::iterator {
+            if constexpr (requires { t.format_to(ctx.out()); }) {
+                return t.format_to(ctx.out());
+            }
+            else if constexpr (fmtu::detail::HasAppendTo<T>) {
+                return fmtu::detail::write_appended(ctx.out(), [&t](std::string& str) -> void {
+                    if constexpr (requires { t.append_to(str); }) {
+                        t.append_to(str);
+                    }
+                    else {
+                        append_to(t, str);
+                    }
+                });
+            }
+            else if constexpr (requires { T::to_string(); }) {
+                return fmtu::detail::write_text(ctx.out(), T::to_string());
+            }
+            else if constexpr (requires { T::toString(); }) {
+                return fmtu::detail::write_text(ctx.out(), T::toString());
+            }
+            else if constexpr (requires { t.to_string(); }) {
+                return fmtu::detail::write_text(ctx.out(), t.to_string());
+            }
+            else if constexpr (requires { t.toString(); }) {
+                return fmtu::detail::write_text(ctx.out(), t.toString());
+            }
+            else if constexpr (requires { to_string(t); }) {
+                return fmtu::detail::write_text(ctx.out(), to_string(t));
+            }
+            else if constexpr (requires { toString(t); }) {
+                return fmtu::detail::write_text(ctx.out(), toString(t));
+            }
+            else {
+                // HasFormatTo only checks std::format_context, a format_to() taking just that iterator can't
+                // serve other contexts such as format_to_fixed().
+                static_assert(sizeof(T) == 0, "format_to() must accept the output iterator of every context");
+            }
+        });
+    }
+};
+
+template<typename T>
+struct std::formatter<fmtu::Diff<T>>
+{
+    fmtu::detail::FmtOpts fmt_opts{};
+
+    template<typename Ctx>
+    constexpr auto parse(Ctx& ctx) -> Ctx::iterator
+    {
+        return fmtu::detail::parse_fmt_opts<fmtu::detail::FmtOpts{ .pretty = true }>(ctx, fmt_opts);
+    }
+
+    template<typename Ctx>
+    auto format(const fmtu::Diff<T>& diff, Ctx& ctx) const -> Ctx::iterator
+    {
+        const std::string_view separator{ fmt_opts.pretty ? "\n" : ", " };
+        auto first{ true };
+        fmtu::detail::write_diff(ctx, diff.old_value(), diff.new_value(), nullptr, separator, first);
+        return ctx.out();
+    }
+};
+
+template<typename T, reflect::fixed_string... Names>
+struct std::formatter<fmtu::Projection<T, Names...>>
+{
+    using Info = fmtu::detail::ProjectionInfo<T, Names...>;
+
+    fmtu::detail::FmtOpts fmt_opts{};
+
+    template<typename Ctx>
+    constexpr auto parse(Ctx& ctx) -> Ctx::iterator
+    {
+        return fmtu::detail::parse_fmt_opts<fmtu::detail::FmtOpts{ .pretty = true }>(ctx, fmt_opts);
+    }
+
+    template<typename Ctx>
+    auto format(const fmtu::Projection<T, Names...>& projection, Ctx& ctx) const -> Ctx::iterator
+    {
+        auto args_tuple{ fmtu::detail::make_projected_args_tuple<Info>(projection.value()) };
+        if (fmt_opts.pretty) {
+            static constexpr auto pretty_fmt{ fmtu::detail::CLASS_PRETTY_FORMAT<Info> };
+            return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
+                return fmtu::detail::format_compiled<pretty_fmt>(ctx, args...);
+            }, args_tuple);
         }
-        else if constexpr (requires { toString(t); }) {
-            return std::format_to(ctx.out(), "{}", toString(t));
+
+        static constexpr auto fmt{ fmtu::detail::CLASS_FORMAT<Info> };
+        return std::apply([&ctx](const auto&... args) -> Ctx::iterator {
+            return fmtu::detail::format_compiled<fmt>(ctx, args...);
+        }, args_tuple);
+    }
+};
+
+template<typename T>
+struct std::formatter<fmtu::Cached<T>>
+{
+    std::string_view spec{};
+
+    template<typename Ctx>
+    constexpr auto parse(Ctx& ctx) -> Ctx::iterator
+    {
+        std::formatter<T> formatter{};
+        auto it{ formatter.parse(ctx) };
+        spec = std::string_view{ ctx.begin(), it };
+        // Cached re-formats the value alone through a SpecPattern, where a dynamic width or precision has no
+        // argument to refer to.
+        if (spec.size() > fmtu::detail::SpecPattern::MAX_SPEC_SIZE || spec.contains('{')) {
+            throw std::format_error("Cached supports static format specs of up to 13 characters");
         }
-        throw std::format_error("Unreachable");
+        return it;
+    }
+
+    template<typename Ctx>
+    auto format(const fmtu::Cached<T>& cached, Ctx& ctx) const -> Ctx::iterator
+    {
+        return cached.format_to(ctx.out(), spec);
     }
 };
 
+// Moves the formatter of a class out of line. Place FMTU_DECLARE_FORMATTER(T) next to the definition of T
+// (and its Adapter, if any) so every translation unit calls one non-inline std::formatter<T>::format, and
+// FMTU_DEFINE_FORMATTER(T) in exactly one source file, which then holds the only instantiation of the pattern
+// generation, member formatting and Glaze serialization of T. Parsing stays inline, so format strings are
+// still checked at compile time. Both macros are available only when including the header.
+// This only covers T formatted as an argument of its own. A member of type T in another class is still
+// inlined into the parent's patterns, since the nested pretty and sparse layouts depend on the member's
+// indentation level, which its own formatter doesn't know.
+#define FMTU_DECLARE_FORMATTER(...)                                                                          \
+    template<>                                                                                               \
+    struct std::formatter<__VA_ARGS__> : fmtu::detail::ClassFormatter<__VA_ARGS__>                           \
+    {                                                                                                        \
+        using fmtu::detail::ClassFormatter<__VA_ARGS__>::format;                                             \
+        auto format(const __VA_ARGS__& value, std::format_context& ctx) const                                \
+          -> std::format_context::iterator;                                                                  \
+    }
+
+#define FMTU_DEFINE_FORMATTER(...)                                                                           \
+    auto std::formatter<__VA_ARGS__>::format(const __VA_ARGS__& value, std::format_context& ctx) const       \
+      -> std::format_context::iterator                                                                       \
+    {                                                                                                        \
+        return fmtu::detail::ClassFormatter<__VA_ARGS__>::format(value, ctx);                                \
+    }
+
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic pop
 #endif
@@ -0,0 +1,348 @@
+#pragma once
+
+// Output to POSIX file descriptors and memory-mapped files. Kept out of format_utils.hpp so that only the
+// translation units that write to files see the POSIX system headers and their macros.
+
+#include "format_utils.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FMTU_HAS_POSIX_IO 1
+#else
+#define FMTU_HAS_POSIX_IO 0
+#endif
+
+#if FMTU_HAS_POSIX_IO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if FMTU_HAS_POSIX_IO
+namespace fmtu
+{
+    namespace detail
+    {
+        // Writes all iovecs, retrying on EINTR and partial writes.
+        inline auto write_all(int fd, std::span<iovec> iov) -> void
+        {
+            while (!iov.empty()) {
+                const auto count{ std::min(iov.size(), static_cast<size_t>(IOV_MAX)) };
+                const auto written{ ::writev(fd, iov.data(), static_cast<int>(count)) };
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "writev failed");
+                }
+
+                auto remaining{ static_cast<size_t>(written) };
+                while (!iov.empty() && remaining >= iov.front().iov_len) {
+                    remaining -= iov.front().iov_len;
+                    iov = iov.subspan(1);
+                }
+                if (!iov.empty()) {
+                    iov.front().iov_base = static_cast<char*>(iov.front().iov_base) + remaining;
+                    iov.front().iov_len -= remaining;
+                }
+            }
+        }
+    }
+
+    // Buffered sink writing to a file descriptor, formatters write into the buffer through the iterator
+    // returned by out() and the buffer is flushed with writev(2) whenever it is full. Output larger than
+    // the buffer is written straight from its source together with the buffered bytes. With an alignment
+    // above alignof(std::max_align_t) the buffer and all full-buffer writes are aligned to it, which keeps
+    // every write but the final flush() suitable for O_DIRECT descriptors.
+    class FdSink
+    {
+      public:
+        using value_type = char; // NOLINT(readability-identifier-naming)
+
+        static constexpr size_t DEFAULT_CAPACITY{ 64UZ * 1024 };
+
+        explicit FdSink(int fd,
+                        size_t capacity = DEFAULT_CAPACITY,
+                        size_t alignment = alignof(std::max_align_t))
+          : m_fd{ fd }
+          , m_alignment{ std::bit_ceil(std::max(alignment, alignof(std::max_align_t))) }
+          , m_capacity{ (std::max(capacity, 1UZ) + m_alignment - 1) / m_alignment * m_alignment }
+          , m_owned{ static_cast<char*>(::operator new(m_capacity, std::align_val_t{ m_alignment })),
+                     AlignedDelete{ m_alignment } }
+          , m_buffer{ m_owned.get(), m_capacity }
+        {
+        }
+
+        // Uses caller provided storage, e.g. a stack array, instead of allocating the buffer.
+        FdSink(int fd, std::span<char> storage)
+          : m_fd{ fd }
+          , m_capacity{ storage.size() }
+          , m_buffer{ storage }
+        {
+            if (storage.empty()) {
+                throw std::invalid_argument("FdSink storage must not be empty");
+            }
+        }
+
+        FdSink(const FdSink&) = delete;
+        FdSink(FdSink&&) = delete;
+        auto operator=(const FdSink&) -> FdSink& = delete;
+        auto operator=(FdSink&&) -> FdSink& = delete;
+
+        // Flushes remaining output, errors are swallowed here so call flush() to observe them.
+        ~FdSink()
+        {
+            try {
+                flush();
+            }
+            catch (...) { // NOLINT(bugprone-empty-catch)
+            }
+        }
+
+        auto push_back(char c) -> void
+        {
+            if (m_size == m_capacity) {
+                flush();
+            }
+            m_buffer[m_size++] = c;
+        }
+
+        auto write(std::string_view text) -> void
+        {
+            if (text.size() <= m_capacity - m_size) {
+                std::ranges::copy(text, m_buffer.begin() + static_cast<std::ptrdiff_t>(m_size));
+                m_size += text.size();
+                return;
+            }
+
+            if (m_alignment > alignof(std::max_align_t)) {
+                while (!text.empty()) {
+                    const auto count{ std::min(text.size(), m_capacity - m_size) };
+                    std::ranges::copy(text.substr(0, count),
+                                      m_buffer.begin() + static_cast<std::ptrdiff_t>(m_size));
+                    m_size += count;
+                    text.remove_prefix(count);
+                    if (m_size == m_capacity) {
+                        flush();
+                    }
+                }
+                return;
+            }
+
+            // NOLINTBEGIN(cppcoreguidelines-pro-type-const-cast)
+            std::array iov{ iovec{ .iov_base = m_buffer.data(), .iov_len = m_size },
+                            iovec{ .iov_base = const_cast<char*>(text.data()), .iov_len = text.size() } };
+            // NOLINTEND(cppcoreguidelines-pro-type-const-cast)
+            m_size = 0;
+            detail::write_all(m_fd, iov);
+        }
+
+        // Drops the buffered output without writing it, output already flushed stays written.
+        auto discard() -> void { m_size = 0; }
+
+        auto flush() -> void
+        {
+            if (m_size == 0) {
+                return;
+            }
+            std::array iov{ iovec{ .iov_base = m_buffer.data(), .iov_len = m_size } };
+            m_size = 0;
+            detail::write_all(m_fd, iov);
+        }
+
+        auto out() -> std::back_insert_iterator<FdSink> { return std::back_inserter(*this); }
+
+        auto size() const -> size_t { return m_size; }
+        auto capacity() const -> size_t { return m_capacity; }
+
+      private:
+        struct AlignedDelete
+        {
+            size_t alignment{ alignof(std::max_align_t) };
+
+            auto operator()(char* ptr) const -> void
+            {
+                ::operator delete(ptr, std::align_val_t{ alignment });
+            }
+        };
+
+        int m_fd{ -1 };
+        size_t m_alignment{ alignof(std::max_align_t) };
+        size_t m_capacity{ 0UZ };
+        std::unique_ptr<char, AlignedDelete> m_owned{};
+        std::span<char> m_buffer{};
+        size_t m_size{ 0UZ };
+    };
+
+    // Output sink writing into a memory-mapped file, formatters write directly into page-cache memory
+    // through the iterator returned by out(). The file is grown with ftruncate(2) one window at a time and
+    // the next window is mapped once the current one is full; close() truncates it to the bytes written.
+    class MmapWriter
+    {
+      public:
+        using value_type = char; // NOLINT(readability-identifier-naming)
+
+        static constexpr size_t DEFAULT_WINDOW_SIZE{ 64UZ * 1024 * 1024 };
+
+        explicit MmapWriter(const char* path, size_t window_size = DEFAULT_WINDOW_SIZE)
+        {
+            const auto page_size{ static_cast<size_t>(::sysconf(_SC_PAGESIZE)) };
+            m_window_size = (std::max(window_size, 1UZ) + page_size - 1) / page_size * page_size;
+
+            m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); // NOLINT
+            if (m_fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "open failed");
+            }
+            try {
+                map_next_window();
+            }
+            catch (...) {
+                ::close(m_fd);
+                throw;
+            }
+        }
+
+        MmapWriter(const MmapWriter&) = delete;
+        MmapWriter(MmapWriter&&) = delete;
+        auto operator=(const MmapWriter&) -> MmapWriter& = delete;
+        auto operator=(MmapWriter&&) -> MmapWriter& = delete;
+
+        // Closes the file, errors are swallowed here so call close() to observe them.
+        ~MmapWriter()
+        {
+            try {
+                close();
+            }
+            catch (...) { // NOLINT(bugprone-empty-catch)
+            }
+        }
+
+        auto push_back(char c) -> void
+        {
+            if (m_pos == m_window_size) {
+                map_next_window();
+            }
+            m_window[m_pos++] = c;
+        }
+
+        auto write(std::string_view text) -> void
+        {
+            while (!text.empty()) {
+                if (m_pos == m_window_size) {
+                    map_next_window();
+                }
+                const auto count{ std::min(text.size(), m_window_size - m_pos) };
+                std::ranges::copy(text.substr(0, count), m_window + m_pos);
+                m_pos += count;
+                text.remove_prefix(count);
+            }
+        }
+
+        auto out() -> std::back_insert_iterator<MmapWriter> { return std::back_inserter(*this); }
+
+        // Bytes written so far.
+        auto size() const -> size_t { return m_offset + m_pos; }
+
+        // Unmaps the current window and truncates the file to size(), further writes are not allowed.
+        auto close() -> void
+        {
+            if (m_fd < 0) {
+                return;
+            }
+            const auto final_size{ size() };
+            unmap_window();
+            // Leaves no writable window, so a later push_back() or write() throws instead of writing.
+            m_offset = final_size;
+            m_pos = 0;
+            m_window_size = 0;
+            const auto fd{ std::exchange(m_fd, -1) };
+            const auto truncated{ ::ftruncate(fd, static_cast<off_t>(final_size)) };
+            const auto error{ errno };
+            ::close(fd);
+            if (truncated != 0) {
+                throw std::system_error(error, std::generic_category(), "ftruncate failed");
+            }
+        }
+
+      private:
+        auto unmap_window() -> void
+        {
+            if (m_window != nullptr) {
+                ::munmap(m_window, m_window_size);
+                m_window = nullptr;
+            }
+        }
+
+        // Maps the window following the current one, the current window stays valid if this throws.
+        auto map_next_window() -> void
+        {
+            if (m_fd < 0) {
+                throw std::logic_error("MmapWriter is closed");
+            }
+            const auto offset{ m_window != nullptr ? m_offset + m_window_size : m_offset };
+            if (::ftruncate(m_fd, static_cast<off_t>(offset + m_window_size)) != 0) {
+                throw std::system_error(errno, std::generic_category(), "ftruncate failed");
+            }
+            auto* window{ ::mmap(
+              nullptr, m_window_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(offset)) };
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr)
+            if (window == MAP_FAILED) {
+                throw std::system_error(errno, std::generic_category(), "mmap failed");
+            }
+
+            unmap_window();
+            m_window = static_cast<char*>(window);
+            m_offset = offset;
+            m_pos = 0;
+        }
+
+        int m_fd{ -1 };
+        size_t m_window_size{ 0UZ };
+        size_t m_offset{ 0UZ };
+        size_t m_pos{ 0UZ };
+        char* m_window{ nullptr };
+    };
+
+    // Formats into a buffered sink, flushing only when its buffer is full.
+    template<typename... Args>
+    auto print_to(FdSink& sink, std::format_string<Args...> fmt, Args&&... args) -> void
+    {
+        std::format_to(sink.out(), fmt, std::forward<Args>(args)...);
+    }
+
+    // Formats straight to a file descriptor through a stack buffer, without touching the heap. If formatting
+    // throws, the buffered part of the record is dropped instead of being flushed by ~FdSink; only records
+    // longer than the buffer can leave a partial write behind.
+    template<typename... Args>
+    auto print_to(int fd, std::format_string<Args...> fmt, Args&&... args) -> void
+    {
+        std::array<char, 4096> storage; // NOLINT(cppcoreguidelines-pro-type-member-init)
+        FdSink sink{ fd, storage };
+        try {
+            std::format_to(sink.out(), fmt, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            sink.discard();
+            throw;
+        }
+        sink.flush();
+    }
+}
+#endif
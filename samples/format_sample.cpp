@@ -150,6 +150,11 @@ int main()
     std::println("");
 #endif
 
+#ifdef FMTU_ENABLE_BEVE
+    std::println("BEVE: {} bytes", std::format("{:b}", user).size());
+    std::println("");
+#endif
+
     // -------------------------------------------------
     // Scenario 4: Enums
     // -------------------------------------------------
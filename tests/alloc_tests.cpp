@@ -0,0 +1,175 @@
+#include "format_utils.hpp"
+
+// NOLINTBEGIN
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions so every heap allocation made on the test thread is counted. The
+// counter is thread-local, so allocations made by other threads do not disturb the measurements.
+namespace
+{
+    thread_local size_t allocation_count{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// Formats into a pre-reserved string and returns the number of allocations made by the second call. The
+// first call warms up per-thread state (the Glaze buffer, FMTU_ENABLE_STATS counters) that is allocated once.
+template<typename... Args>
+size_t count_allocations(std::format_string<const Args&...> fmt, const Args&... args)
+{
+    std::string out;
+    out.reserve(4096);
+    std::format_to(std::back_inserter(out), fmt, args...);
+    out.clear();
+
+    const size_t before = allocation_count;
+    std::format_to(std::back_inserter(out), fmt, args...);
+    const size_t allocations = allocation_count - before;
+
+    EXPECT_EQ(out, std::format(fmt, args...));
+    return allocations;
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Test Types
+// -----------------------------------------------------------------------------
+
+struct SimpleAggregate
+{
+    int id;
+    double value;
+    bool active;
+};
+
+struct NestedAggregate
+{
+    std::string name;
+    SimpleAggregate simple;
+};
+
+class ClassWithAdapter
+{
+  public:
+    ClassWithAdapter(int id, std::string name)
+      : m_id(id)
+      , m_name(std::move(name))
+    {
+    }
+
+    int getId() const { return m_id; }
+    const std::string& getName() const { return m_name; }
+
+  private:
+    int m_id;
+    std::string m_name;
+};
+
+template<>
+struct fmtu::Adapter<ClassWithAdapter>
+{
+    using Fields = std::tuple<fmtu::Field<"id", &ClassWithAdapter::getId>,
+                              fmtu::Field<"name", &ClassWithAdapter::getName>>;
+};
+
+enum class TestEnum
+{
+    ValueA,
+    ValueB,
+    ValueC
+};
+
+// -----------------------------------------------------------------------------
+// Test Suite: Allocation Counts
+// -----------------------------------------------------------------------------
+
+TEST(AllocTests, Counter_SeesAllocations)
+{
+    const size_t before = allocation_count;
+    void* ptr = ::operator new(16);
+    EXPECT_EQ(allocation_count - before, 1u);
+    ::operator delete(ptr);
+}
+
+TEST(AllocTests, Aggregate_Compact)
+{
+    const NestedAggregate nested{ "a name longer than any small string buffer", { 1, 0.5, false } };
+    EXPECT_EQ(count_allocations("{}", SimpleAggregate{ 42, 3.14, true }), 0u);
+    EXPECT_EQ(count_allocations("{}", nested), 0u);
+}
+
+TEST(AllocTests, Aggregate_Pretty)
+{
+    const NestedAggregate nested{ "a name longer than any small string buffer", { 1, 0.5, false } };
+    EXPECT_EQ(count_allocations("{:p}", SimpleAggregate{ 42, 3.14, true }), 0u);
+    EXPECT_EQ(count_allocations("{:p}", nested), 0u);
+}
+
+TEST(AllocTests, Adapter_CompactAndPretty)
+{
+    const ClassWithAdapter value{ 100, "a name longer than any small string buffer" };
+    EXPECT_EQ(count_allocations("{}", value), 0u);
+    EXPECT_EQ(count_allocations("{:p}", value), 0u);
+}
+
+TEST(AllocTests, Enum_DefaultAndVerbose)
+{
+    EXPECT_EQ(count_allocations("{}", TestEnum::ValueB), 0u);
+    EXPECT_EQ(count_allocations("{:v}", TestEnum::ValueC), 0u);
+}
+
+#ifdef FMTU_ENABLE_JSON
+// Glaze writes into a per-thread buffer that keeps its capacity, so once warmed up an aggregate serializes
+// without allocating. Adapter fields go through glz::custom getters, which may materialize one value each.
+static constexpr size_t MAX_ADAPTER_JSON_ALLOCATIONS{ 2 };
+
+TEST(AllocTests, JSON_WithinBound)
+{
+    EXPECT_EQ(count_allocations("{:j}", SimpleAggregate{ 10, 20.5, true }), 0u);
+    EXPECT_EQ(count_allocations("{:pj}", SimpleAggregate{ 10, 20.5, true }), 0u);
+    EXPECT_LE(count_allocations("{:j}", ClassWithAdapter{ 100, "TestObj" }), MAX_ADAPTER_JSON_ALLOCATIONS);
+}
+#endif
+
+// NOLINTEND
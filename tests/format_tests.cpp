@@ -1,9 +1,17 @@
 #include "format_utils.hpp"
+#include "format_utils_io.hpp"
+#include "out_of_line_types.hpp"
 
 // NOLINTBEGIN
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <locale>
+#include <memory_resource>
+#include <numeric>
+#include <thread>
+
 int main(int argc, char* argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -60,6 +68,62 @@ TEST(FormatTests, Aggregate_Nested)
     EXPECT_EQ(result, expected);
 }
 
+TEST(FormatTests, Aggregate_NestedPatternsReuseChildren)
+{
+    using Parent = fmtu::detail::ReflectableInfo<NestedAggregate>;
+    using Child = fmtu::detail::ReflectableInfo<SimpleAggregate>;
+    std::string_view child = fmtu::detail::CLASS_FORMAT<Child>;
+    std::string_view parent = fmtu::detail::CLASS_FORMAT<Parent>;
+    EXPECT_EQ(parent, std::string("[ NestedAggregate: {{ name: {}, simple: ") + std::string(child) + " }} ]");
+
+    std::string_view pretty_child = fmtu::detail::CLASS_PRETTY_FORMAT<Child, 1>;
+    std::string_view pretty_parent = fmtu::detail::CLASS_PRETTY_FORMAT<Parent>;
+    EXPECT_NE(pretty_parent.find(pretty_child), std::string_view::npos);
+}
+
+struct MixedAggregate
+{
+    char tag;
+    std::string_view label;
+    std::vector<int> values;
+    std::optional<int> maybe;
+    std::array<char, 3> chars;
+};
+
+TEST(FormatTests, Aggregate_MatchesFormatTo)
+{
+    MixedAggregate value{ 'x', "label", { 1, 2, 3 }, std::nullopt, { 'a', 'b', 'c' } };
+    std::string result = std::format("{}", value);
+    std::string expected =
+      std::format("[ MixedAggregate: {{ tag: {}, label: {}, values: {}, maybe: {}, chars: {} }} ]",
+                  value.tag,
+                  value.label,
+                  value.values,
+                  value.maybe,
+                  value.chars);
+    EXPECT_EQ(result, expected);
+}
+
+struct AggregateWithAggregateContainers
+{
+    int id;
+    std::vector<SimpleAggregate> items;
+    std::array<SimpleAggregate, 1> pinned;
+    std::optional<SimpleAggregate> extra;
+};
+
+TEST(FormatTests, Aggregate_ContainersOfAggregates)
+{
+    AggregateWithAggregateContainers value{ 1, { { 1, 0.5, true } }, { { { 2, 0.5, true } } }, std::nullopt };
+    std::string result = std::format("{}", value);
+    std::string expected =
+      std::format("[ AggregateWithAggregateContainers: {{ id: 1, items: {}, pinned: {}, extra: {} }} ]",
+                  value.items,
+                  value.pinned,
+                  value.extra);
+    EXPECT_EQ(result, expected);
+}
+
 #ifndef FMTU_ENABLE_GLAZE
 #include <mutex>
 
@@ -77,6 +141,77 @@ TEST(FormatTests, Aggregate_NonFormattableMember)
 }
 #endif
 
+struct BraceCheckingMember
+{
+    int value;
+};
+
+template<>
+struct std::formatter<BraceCheckingMember>
+{
+    constexpr auto parse(std::format_parse_context& ctx) -> std::format_parse_context::iterator
+    {
+        if (ctx.begin() == ctx.end() || *ctx.begin() != '}') {
+            throw std::format_error("Expected the closing brace");
+        }
+        return ctx.begin();
+    }
+
+    auto format(const BraceCheckingMember& member, std::format_context& ctx) const
+      -> std::format_context::iterator
+    {
+        return std::format_to(ctx.out(), "<{}>", member.value);
+    }
+};
+
+struct AggregateWithBraceCheckingMember
+{
+    int id;
+    BraceCheckingMember member;
+};
+
+TEST(FormatTests, Aggregate_MemberParseSeesClosingBrace)
+{
+    std::string result = std::format("{}", AggregateWithBraceCheckingMember{ 1, { 2 } });
+    std::string expected = "[ AggregateWithBraceCheckingMember: { id: 1, member: <2> } ]";
+    EXPECT_EQ(result, expected);
+}
+
+struct Price
+{
+    int cents;
+};
+
+template<>
+struct std::formatter<Price> : std::formatter<int>
+{
+    auto format(const Price& price, std::format_context& ctx) const -> std::format_context::iterator
+    {
+        return std::format_to(ctx.out(), "${}.{:02}", price.cents / 100, price.cents % 100);
+    }
+};
+
+struct AggregateWithCustomFormattedAggregate
+{
+    int id;
+    Price price;
+};
+
+TEST(FormatTests, Aggregate_NestedAggregateUsesItsOwnFormatter)
+{
+    static_assert(!fmtu::detail::ClassFormatted<Price>);
+    static_assert(fmtu::detail::ClassFormatted<AggregateWithCustomFormattedAggregate>);
+
+    const AggregateWithCustomFormattedAggregate value{ 1, { 250 } };
+    EXPECT_EQ(std::format("{}", value), "[ AggregateWithCustomFormattedAggregate: { id: 1, price: $2.50 } ]");
+    EXPECT_EQ(std::format("{:p}", value), R"(AggregateWithCustomFormattedAggregate: {
+  id: 1,
+  price: $2.50
+})");
+    EXPECT_EQ(std::format("{:s}", AggregateWithCustomFormattedAggregate{ 0, { 5 } }),
+              "[ AggregateWithCustomFormattedAggregate: { price: $0.05 } ]");
+}
+
 // -----------------------------------------------------------------------------
 // Test Suite: Adapters (Encapsulated Classes)
 // -----------------------------------------------------------------------------
@@ -129,6 +264,36 @@ TEST(FormatTests, Adapter_Pretty)
     EXPECT_EQ(result, expected);
 }
 
+class ClassWithNestedAdapter
+{
+  public:
+    explicit ClassWithNestedAdapter(int id)
+      : m_id(id)
+    {
+    }
+
+    SimpleAggregate getSimple() const { return { m_id, 0.5, true }; }
+    ClassWithAdapter getInner() const { return { m_id * 2, "Inner" }; }
+
+  private:
+    int m_id;
+};
+
+template<>
+struct fmtu::Adapter<ClassWithNestedAdapter>
+{
+    using Fields = std::tuple<fmtu::Field<"simple", &ClassWithNestedAdapter::getSimple>,
+                              fmtu::Field<"inner", &ClassWithNestedAdapter::getInner>>;
+};
+
+TEST(FormatTests, Adapter_NestedByValue)
+{
+    std::string result = std::format("{}", ClassWithNestedAdapter{ 3 });
+    std::string expected = "[ ClassWithNestedAdapter: { simple: [ SimpleAggregate: { id: 3, value: 0.5, "
+                           "active: true } ], inner: [ ClassWithAdapter: { id: 6, name: Inner } ] } ]";
+    EXPECT_EQ(result, expected);
+}
+
 // -----------------------------------------------------------------------------
 // Test Suite: Enums
 // -----------------------------------------------------------------------------
@@ -154,6 +319,41 @@ TEST(FormatTests, Enum_Verbose)
     EXPECT_EQ(result, expected);
 }
 
+enum class SparseEnum
+{
+    First = 1,
+    Tenth = 10,
+    Twentieth = 20
+};
+
+TEST(FormatTests, Enum_Sparse)
+{
+    std::string result =
+      std::format("{} {:v} {}", SparseEnum::Tenth, SparseEnum::Twentieth, SparseEnum::First);
+    std::string expected = "Tenth SparseEnum::Twentieth First";
+    EXPECT_EQ(result, expected);
+}
+
+TEST(FormatTests, Enum_FromString)
+{
+    EXPECT_EQ(fmtu::enum_from_string<TestEnum>("ValueA"), TestEnum::ValueA);
+    EXPECT_EQ(fmtu::enum_from_string<TestEnum>("ValueC"), TestEnum::ValueC);
+    EXPECT_EQ(fmtu::enum_from_string<TestEnum>("TestEnum::ValueB"), TestEnum::ValueB);
+    EXPECT_EQ(fmtu::enum_from_string<SparseEnum>("Twentieth"), SparseEnum::Twentieth);
+    EXPECT_EQ(fmtu::enum_from_string<TestEnum>("ValueD"), std::nullopt);
+    EXPECT_EQ(fmtu::enum_from_string<TestEnum>(""), std::nullopt);
+    EXPECT_EQ(fmtu::enum_from_string<TestEnum>("TestEnum::"), std::nullopt);
+    static_assert(fmtu::enum_from_string<TestEnum>("ValueB") == TestEnum::ValueB);
+}
+
+TEST(FormatTests, Enum_RoundTrip)
+{
+    for (auto e : fmtu::detail::enumerators<SparseEnum>()) {
+        EXPECT_EQ(fmtu::enum_from_string<SparseEnum>(std::format("{}", e)), e);
+        EXPECT_EQ(fmtu::enum_from_string<SparseEnum>(std::format("{:v}", e)), e);
+    }
+}
+
 // -----------------------------------------------------------------------------
 // Test Suite: Optionals
 // -----------------------------------------------------------------------------
@@ -266,188 +466,1257 @@ TEST(FormatTests, Pointer_Null)
 }
 
 // -----------------------------------------------------------------------------
-// Test Suite: Serialization (JSON / TOML)
+// Test Suite: Format Specs
 // -----------------------------------------------------------------------------
 
-#ifdef FMTU_ENABLE_JSON
-TEST(FormatTests, JSON_Compact)
+TEST(FormatTests, Specs_RuntimeCompatible)
 {
-    std::string result = std::format("{:j}", SimpleAggregate{ 10, 20.5, true });
-    std::string expected = R"({"id":10,"value":20.5,"active":true})";
+    SimpleAggregate value{ 42, 3.14, true };
+    std::string result = std::vformat("{:vp}", std::make_format_args(value));
+    std::string expected = std::format("{:p}", value);
     EXPECT_EQ(result, expected);
 }
 
-TEST(FormatTests, JSON_Pretty)
+TEST(FormatTests, Specs_RuntimeInvalid)
 {
-    std::string result = std::format("{:pj}", ClassWithAdapter{ 100, "TestObj" });
-    std::string expected = R"({
-   "id": 100,
-   "name": "TestObj"
-})";
-    EXPECT_EQ(result, expected);
+    SimpleAggregate value{ 42, 3.14, true };
+    TestEnum e = TestEnum::ValueA;
+    EXPECT_THROW((void)std::vformat("{:x}", std::make_format_args(value)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:vj}", std::make_format_args(value)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:p}", std::make_format_args(e)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:\xff}", std::make_format_args(e)), std::format_error);
 }
-#endif
 
-#ifdef FMTU_ENABLE_YAML
-TEST(FormatTests, YAML_Basic)
+// -----------------------------------------------------------------------------
+// Test Suite: Sparse Output
+// -----------------------------------------------------------------------------
+
+TEST(FormatTests, Sparse_Compact)
 {
-    std::string result = std::format("{:y}", ClassWithAdapter{ 100, "TestObj" });
-    std::string expected = "id:\n100name:\nTestObj";
+    NestedAggregate value{ "", { 7, 0.0, false } };
+    EXPECT_EQ(std::format("{:s}", value), "[ NestedAggregate: { simple: [ SimpleAggregate: { id: 7 } ] } ]");
+    EXPECT_EQ(std::format("{:s}", NestedAggregate{}), "[ NestedAggregate: {} ]");
+    EXPECT_EQ(std::format("{:s}", ClassWithAdapter{ 0, "Name" }), "[ ClassWithAdapter: { name: Name } ]");
+    EXPECT_THROW((void)std::vformat("{:sv}", std::make_format_args(value)), std::format_error);
+}
+
+TEST(FormatTests, Sparse_ContainersOfAggregates)
+{
+    // SimpleAggregate has no operator==, empty containers and disengaged optionals of it are still defaults.
+    EXPECT_EQ(std::format("{:s}", AggregateWithAggregateContainers{ 0, {}, {}, std::nullopt }),
+              "[ AggregateWithAggregateContainers: {} ]");
+
+    AggregateWithAggregateContainers value{ 0, { { 1, 0.5, true } }, {}, SimpleAggregate{} };
+    std::string result = std::format("{:s}", value);
+    std::string expected =
+    // SimpleAggregate has no operator==, yet empty containers and disengaged optionals of it are defaults.
     EXPECT_EQ(result, expected);
 }
-#endif
 
-#ifdef FMTU_ENABLE_TOML
-TEST(FormatTests, TOML_Basic)
+TEST(FormatTests, Sparse_Pretty)
 {
-    std::string result = std::format("{:t}", ClassWithAdapter{ 100, "TestObj" });
-    std::string expected = R"(id = 100
-name = "TestObj")";
+    NestedAggregate value{ "Parent", { 0, 1.5, false } };
+    std::string result = std::format("{:ps}", value);
+    std::string expected = R"(NestedAggregate: {
+  name: Parent,
+  simple: {
+    value: 1.5
+  }
+})";
     EXPECT_EQ(result, expected);
 }
+
+#ifdef FMTU_ENABLE_JSON
+TEST(FormatTests, Sparse_Json)
+{
+    NestedAggregate value{ "", { 3, 0.0, true } };
+    EXPECT_EQ(std::format("{:sj}", value), R"({"simple":{"id":3,"active":true}})");
+    std::string expected = R"({
+   "simple": {
+      "id": 3,
+      "active": true
+   }
+})";
+    EXPECT_EQ(std::format("{:psj}", value), expected);
+}
+
+struct RenamedAggregate
+{
+    int id;
+    std::string label;
+};
+
+template<>
+struct glz::meta<RenamedAggregate>
+{
+    using T = RenamedAggregate;
+    static constexpr auto value = glz::object("Label", &T::label, "ID", &T::id);
+};
+
+struct ComputedAggregate
+{
+    int id;
+};
+
+template<>
+struct glz::meta<ComputedAggregate>
+{
+    static constexpr auto value = glz::object("ID", [](auto&& self) -> auto& { return self.id; });
+};
+
+TEST(FormatTests, Sparse_JsonUsesGlazeMetaKeys)
+{
+    EXPECT_EQ(std::format("{:sj}", RenamedAggregate{ 0, "name" }), R"({"Label":"name"})");
+    RenamedAggregate value{ 1, "name" };
+    EXPECT_EQ(std::format("{:sj}", value), std::format("{:j}", value));
+    EXPECT_EQ(std::format("{:s}", value), "[ RenamedAggregate: { id: 1, label: name } ]");
+
+    // Glaze computes the lambda entry on the fly, so sparse JSON is rejected like {:j} rejects members.
+    ComputedAggregate computed{ 1 };
+    EXPECT_EQ(std::format("{:j}", computed), R"({"ID":1})");
+    EXPECT_THROW((void)std::vformat("{:sj}", std::make_format_args(computed)), std::format_error);
+}
 #endif
 
 // -----------------------------------------------------------------------------
-// Test Suite: Streamable (operator<<)
+// Test Suite: Size Estimation
 // -----------------------------------------------------------------------------
 
-struct StreamableTestStruct
+struct BoundedAggregate
 {
-    int x;
+    int32_t id;
+    bool active;
+    TestEnum state;
+    std::array<uint8_t, 2> bytes;
+    SimpleAggregate nested;
 };
 
-std::ostream& operator<<(std::ostream& os, const StreamableTestStruct& s)
+TEST(FormatTests, Size_ExactMatchesFormat)
 {
-    return os << "StreamableTestStruct(x=" << s.x << ")";
+    SimpleAggregate value{ 42, 3.14, true };
+    EXPECT_EQ(fmtu::formatted_size(value), std::format("{}", value).size());
+    EXPECT_EQ(fmtu::formatted_size(value, "p"), std::format("{:p}", value).size());
+    EXPECT_EQ(fmtu::formatted_size(TestEnum::ValueA, "v"), std::format("{:v}", TestEnum::ValueA).size());
+    EXPECT_THROW((void)fmtu::formatted_size(value, "x"), std::format_error);
 }
 
-TEST(FormatTests, Streamable_Ostream)
+TEST(FormatTests, Size_HintBounds)
 {
-    std::string result = std::format("{}", StreamableTestStruct{ 42 });
-    std::string expected = "StreamableTestStruct(x=42)";
-    EXPECT_EQ(result, expected);
+    constexpr auto hint = fmtu::formatted_size_hint<BoundedAggregate>();
+    static_assert(hint.upper.has_value());
+
+    SimpleAggregate widest_nested{ std::numeric_limits<int>::min(),
+                                   -std::numeric_limits<double>::min(),
+                                   false };
+    BoundedAggregate widest{
+        std::numeric_limits<int32_t>::min(), false, TestEnum::ValueA, { 255, 255 }, widest_nested
+    };
+    BoundedAggregate narrowest{ 0, true, TestEnum::ValueA, { 0, 0 }, { 0, 0.0, true } };
+    EXPECT_EQ(fmtu::formatted_size(widest), hint.upper.value());
+    EXPECT_EQ(fmtu::formatted_size(narrowest), hint.lower);
+
+    static_assert(!fmtu::formatted_size_hint<NestedAggregate>().upper.has_value());
+    EXPECT_LE(fmtu::formatted_size_hint<NestedAggregate>().lower,
+              fmtu::formatted_size(NestedAggregate{ "", { 0, 0.0, true } }));
 }
 
 // -----------------------------------------------------------------------------
-// Test Suite: HasToString (toString(), to_string(), etc.)
+// Test Suite: Memory Resources
 // -----------------------------------------------------------------------------
 
-struct ToStringTestStruct
+class CountingResource : public std::pmr::memory_resource
 {
-    std::string toString() const { return "ToStringTestStruct"; }
+  public:
+    size_t allocations = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
 };
 
-TEST(FormatTests, HasToString_MemberToString)
+TEST(FormatTests, Resource_MatchesStdFormat)
 {
-    std::string result = std::format("{}", ToStringTestStruct{});
-    std::string expected = "ToStringTestStruct";
-    EXPECT_EQ(result, expected);
+    CountingResource resource;
+    NestedAggregate value{ "a name that does not fit into the small string buffer", { 1, 2.5, true } };
+    std::pmr::string result = fmtu::format(&resource, "{} {:p}", value, value);
+    EXPECT_EQ(result, std::format("{} {:p}", value, value));
+    EXPECT_EQ(result.get_allocator().resource(), &resource);
+    EXPECT_GT(resource.allocations, 0u);
+    EXPECT_EQ(fmtu::detail::scoped_resource(), nullptr);
 }
 
-struct SnakeCaseToStringStruct
-{
-    std::string to_string() const { return "SnakeCaseToStringStruct"; }
-};
-
-TEST(FormatTests, HasToString_MemberSnakeCase)
+TEST(FormatTests, Resource_MonotonicArena)
 {
-    std::string result = std::format("{}", SnakeCaseToStringStruct{});
-    std::string expected = "SnakeCaseToStringStruct";
-    EXPECT_EQ(result, expected);
+    std::array<std::byte, 4096> storage;
+    std::pmr::monotonic_buffer_resource arena{ storage.data(),
+                                               storage.size(),
+                                               std::pmr::null_memory_resource() };
+    std::pmr::string result = fmtu::format(&arena, "{}", SimpleAggregate{ 7, 0.5, false });
+    EXPECT_EQ(result, "[ SimpleAggregate: { id: 7, value: 0.5, active: false } ]");
 }
 
-struct FreeToStringStruct
+#ifdef FMTU_ENABLE_JSON
+TEST(FormatTests, Resource_JsonUsesResource)
 {
-};
+    CountingResource resource;
+    std::pmr::string result = fmtu::format(&resource, "{:j}", SimpleAggregate{ 10, 20.5, true });
+    EXPECT_EQ(result, R"({"id":10,"value":20.5,"active":true})");
+    EXPECT_GE(resource.allocations, 2u);
+}
+#endif
 
-const char* to_string(const FreeToStringStruct&) { return "FreeToStringStruct"; }
+// -----------------------------------------------------------------------------
+// Test Suite: Deferred Formatting
+// -----------------------------------------------------------------------------
 
-TEST(FormatTests, HasToString_FreeFunction)
+TEST(FormatTests, Deferred_DrainInOrder)
 {
-    std::string result = std::format("{}", FreeToStringStruct{});
-    std::string expected = "FreeToStringStruct";
+    fmtu::DeferredQueue<SimpleAggregate, 4> queue;
+    EXPECT_TRUE(queue.push({ 1, 1.5, true }));
+    EXPECT_TRUE(queue.push({ 2, 2.5, false }));
+
+    std::string result;
+    queue.drain(std::back_inserter(result));
+    std::string expected = "[ SimpleAggregate: { id: 1, value: 1.5, active: true } ]\n"
+                           "[ SimpleAggregate: { id: 2, value: 2.5, active: false } ]\n";
     EXPECT_EQ(result, expected);
+    EXPECT_FALSE(queue.pop().has_value());
 }
 
-struct StaticToStringStruct
+TEST(FormatTests, Deferred_FullQueueRejects)
 {
-    static constexpr std::string_view toString() { return "StaticToStringStruct"; }
-};
+    fmtu::DeferredQueue<NestedAggregate, 2> queue;
+    EXPECT_TRUE(queue.push({ "a", {} }));
+    EXPECT_TRUE(queue.push({ "b", {} }));
+    EXPECT_FALSE(queue.push({ "c", {} }));
+    EXPECT_EQ(queue.pop()->name, "a");
+    EXPECT_TRUE(queue.push({ "c", {} }));
+
+    std::string result;
+    queue.drain(std::back_inserter(result), "{:p};");
+    EXPECT_EQ(std::ranges::count(result, ';'), 2);
+}
 
-TEST(FormatTests, HasToString_StaticToString)
+struct ThrowingCopy
 {
-    std::string result = std::format("{}", StaticToStringStruct{});
-    std::string expected = "StaticToStringStruct";
-    EXPECT_EQ(result, expected);
-}
+    int id;
+    bool throw_on_copy;
 
-// -----------------------------------------------------------------------------
-// Test Suite: Format Priority
-// Priority: Adapter > Streamable > HasToString > Reflection
-// -----------------------------------------------------------------------------
+    ThrowingCopy(int id_, bool throw_on_copy_)
+      : id(id_)
+      , throw_on_copy(throw_on_copy_)
+    {
+    }
 
-struct PriorityAdapter
-{
-    int val = 1;
-    std::string toString() const { return "ToString"; }
-};
+    ThrowingCopy(const ThrowingCopy& other)
+      : id(other.id)
+      , throw_on_copy(other.throw_on_copy)
+    {
+        if (throw_on_copy) {
+            throw std::runtime_error("copy failed");
+        }
+    }
 
-std::ostream& operator<<(std::ostream& os, const PriorityAdapter&) { return os << "Streamable"; }
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+};
 
 template<>
-struct fmtu::Adapter<PriorityAdapter>
+struct std::formatter<ThrowingCopy> : std::formatter<int>
 {
-    using Fields = std::tuple<fmtu::Field<"val", &PriorityAdapter::val>>;
+    auto format(const ThrowingCopy& value, std::format_context& ctx) const -> std::format_context::iterator
+    {
+        return std::formatter<int>::format(value.id, ctx);
+    }
 };
 
-TEST(FormatTests, Priority_Adapter)
+TEST(FormatTests, Deferred_ThrowingCopySkipsSlot)
 {
-    std::string result = std::format("{}", PriorityAdapter{});
-    std::string expected = "[ PriorityAdapter: { val: 1 } ]";
-    EXPECT_EQ(result, expected);
+    fmtu::DeferredQueue<ThrowingCopy, 4> queue;
+    EXPECT_TRUE(queue.push({ 1, false }));
+    EXPECT_THROW(queue.push({ 2, true }), std::runtime_error);
+    EXPECT_TRUE(queue.push({ 3, false }));
+
+    std::string result;
+    queue.drain(std::back_inserter(result), "{};");
+    EXPECT_EQ(result, "1;3;");
+    EXPECT_FALSE(queue.pop().has_value());
 }
 
-struct PriorityStreamable
+struct ThrowingMove
 {
-    int val = 2;
-    std::string toString() const { return "ToString"; }
-};
+    int id;
+    bool throw_on_move;
 
-std::ostream& operator<<(std::ostream& os, const PriorityStreamable& s)
-{
-    return os << "Streamable " << s.val;
-}
+    ThrowingMove(int id_, bool throw_on_move_)
+      : id(id_)
+      , throw_on_move(throw_on_move_)
+    {
+    }
 
-TEST(FormatTests, Priority_Streamable)
-{
-    std::string result = std::format("{}", PriorityStreamable{});
-    std::string expected = "Streamable 2";
-    EXPECT_EQ(result, expected);
-}
+    ThrowingMove(const ThrowingMove&) = default;
 
-struct PriorityToString
-{
-    int val = 3;
-    std::string toString() const { return "ToString " + std::to_string(val); }
+    ThrowingMove(ThrowingMove&& other)
+      : id(other.id)
+      , throw_on_move(other.throw_on_move)
+    {
+        if (throw_on_move) {
+            throw std::runtime_error("move failed");
+        }
+    }
 };
 
-TEST(FormatTests, Priority_ToString)
+TEST(FormatTests, Deferred_ThrowingMoveReleasesSlot)
 {
-    std::string result = std::format("{}", PriorityToString{});
-    std::string expected = "ToString 3";
-    EXPECT_EQ(result, expected);
+    fmtu::DeferredQueue<ThrowingMove, 2> queue;
+    const ThrowingMove throwing{ 0, true };
+    EXPECT_TRUE(queue.push(throwing));
+    EXPECT_THROW((void)queue.pop(), std::runtime_error);
+
+    // Wraps around onto the slot of the failed pop several times.
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(queue.push({ i, false }));
+        auto value = queue.pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(value->id, i);
+    }
 }
 
-struct PriorityReflection
+struct DeferredRecord
 {
-    int val = 4;
+    int producer;
+    int sequence;
 };
 
-TEST(FormatTests, Priority_Reflection)
+TEST(FormatTests, Deferred_MultiProducerStress)
 {
-    std::string result = std::format("{}", PriorityReflection{});
+    constexpr int num_producers = 4;
+    constexpr int records_per_producer = 50'000;
+    fmtu::DeferredQueue<DeferredRecord, 1024> queue;
+
+    std::vector<std::jthread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < records_per_producer; ++i) {
+                while (!queue.push({ p, i })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next_sequence(num_producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < num_producers * records_per_producer) {
+        auto record = queue.pop();
+        if (!record) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && record->sequence == next_sequence[record->producer];
+        next_sequence[record->producer] = record->sequence + 1;
+        ++received;
+    }
+    producers.clear();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(received, num_producers * records_per_producer);
+    EXPECT_EQ(next_sequence, std::vector<int>(num_producers, records_per_producer));
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Parallel Formatting
+// -----------------------------------------------------------------------------
+
+TEST(FormatTests, Parallel_MatchesSequential)
+{
+    std::vector<SimpleAggregate> values(5'000);
+    for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+        values[i] = { i, i * 0.25, i % 3 == 0 };
+    }
+
+    std::string expected;
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::format_to(std::back_inserter(expected), "{}{:p}", i == 0 ? "" : "\n", values[i]);
+    }
+    EXPECT_EQ(fmtu::format_range_parallel(values, "p", "\n", 8), expected);
+    EXPECT_EQ(fmtu::format_range_parallel(values, "p", "\n", 1), expected);
+}
+
+TEST(FormatTests, Parallel_SmallAndEmptyRanges)
+{
+    std::vector<SimpleAggregate> values{ { 1, 1.5, true }, { 2, 2.5, false } };
+    std::string expected = "[ SimpleAggregate: { id: 1, value: 1.5, active: true } ]; "
+                           "[ SimpleAggregate: { id: 2, value: 2.5, active: false } ]";
+    EXPECT_EQ(fmtu::format_range_parallel(values, "", "; "), expected);
+    EXPECT_EQ(fmtu::format_range_parallel(std::vector<SimpleAggregate>{}), "");
+    EXPECT_THROW((void)fmtu::format_range_parallel(values, "x"), std::format_error);
+}
+
+TEST(FormatTests, Parallel_EmptyElementsKeepSeparators)
+{
+    std::vector<std::string> values(2'000);
+    std::string expected;
+    for (size_t i = 0; i < values.size(); ++i) {
+        expected += i == 0 ? "" : ",";
+    }
+    EXPECT_EQ(fmtu::format_range_parallel(values, "", ",", 4), expected);
+}
+
+#if FMTU_HAS_POSIX_IO
+// -----------------------------------------------------------------------------
+// Test Suite: File Descriptor Output
+// -----------------------------------------------------------------------------
+
+static std::string read_all(int fd)
+{
+    std::string result;
+    std::array<char, 4096> chunk;
+    ssize_t count = 0;
+    while ((count = ::read(fd, chunk.data(), chunk.size())) > 0) {
+        result.append(chunk.data(), static_cast<size_t>(count));
+    }
+    return result;
+}
+
+TEST(FormatTests, FdSink_EmptyFlushSkipsSyscall)
+{
+    fmtu::FdSink sink{ -1 };
+    EXPECT_NO_THROW(sink.flush());
+    sink.push_back('x');
+    EXPECT_THROW(sink.flush(), std::system_error);
+}
+
+TEST(FormatTests, FdSink_PipeBuffersUntilFlush)
+{
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::pipe(fds.data()), 0);
+    {
+        fmtu::FdSink sink{ fds[1], 64 };
+        fmtu::print_to(sink, "{}", SimpleAggregate{ 1, 0.5, true });
+        fmtu::print_to(sink, "|{:p}", NestedAggregate{ "n", { 2, 1.5, false } });
+        sink.write("|" + std::string(200, 'y'));
+    }
+    ::close(fds[1]);
+
+    std::string expected = std::format("{}|{:p}|{}",
+                                       SimpleAggregate{ 1, 0.5, true },
+                                       NestedAggregate{ "n", { 2, 1.5, false } },
+                                       std::string(200, 'y'));
+    EXPECT_EQ(read_all(fds[0]), expected);
+    ::close(fds[0]);
+}
+
+TEST(FormatTests, FdSink_TempFileLargeAndAligned)
+{
+    std::array<char, 32> path{ "/tmp/fmtu_fd_sink_XXXXXX" };
+    const int fd = ::mkstemp(path.data());
+    ASSERT_GE(fd, 0);
+
+    std::string expected;
+    {
+        fmtu::FdSink sink{ fd, 1000, 512 };
+        EXPECT_EQ(sink.capacity(), 1024u);
+        for (int i = 0; i < 2000; ++i) {
+            fmtu::print_to(sink, "{}\n", SimpleAggregate{ i, i * 0.5, i % 2 == 0 });
+            std::format_to(std::back_inserter(expected), "{}\n", SimpleAggregate{ i, i * 0.5, i % 2 == 0 });
+        }
+        sink.write(std::string(5000, 'x'));
+        expected.append(5000, 'x');
+    }
+    fmtu::print_to(fd, "{}", TestEnum::ValueB);
+    expected += std::format("{}", TestEnum::ValueB);
+
+    ::lseek(fd, 0, SEEK_SET);
+    EXPECT_EQ(read_all(fd), expected);
+    ::close(fd);
+    ::unlink(path.data());
+}
+
+struct ThrowingFormatted
+{
+};
+
+template<>
+struct std::formatter<ThrowingFormatted>
+{
+    constexpr auto parse(std::format_parse_context& ctx) -> std::format_parse_context::iterator
+    {
+        return ctx.begin();
+    }
+
+    auto format(const ThrowingFormatted& /*unused*/, std::format_context& ctx) const
+      -> std::format_context::iterator
+    {
+        std::format_to(ctx.out(), "partial");
+        throw std::format_error("format failed");
+    }
+};
+
+TEST(FormatTests, FdSink_PrintToDropsFailedRecord)
+{
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::pipe(fds.data()), 0);
+    EXPECT_THROW(fmtu::print_to(fds[1], "head {}\n", ThrowingFormatted{}), std::format_error);
+    fmtu::print_to(fds[1], "{}\n", TestEnum::ValueA);
+    ::close(fds[1]);
+
+    EXPECT_EQ(read_all(fds[0]), "ValueA\n");
+    ::close(fds[0]);
+}
+
+TEST(FormatTests, MmapWriter_GrowsAndTruncates)
+{
+    std::array<char, 32> path{ "/tmp/fmtu_mmap_XXXXXX" };
+    const int fd = ::mkstemp(path.data());
+    ASSERT_GE(fd, 0);
+
+    std::string expected;
+    {
+        fmtu::MmapWriter writer{ path.data(), 1 };
+        for (int i = 0; i < 1000; ++i) {
+            NestedAggregate value{ std::format("item{}", i), { i, i * 0.5, i % 2 == 0 } };
+            std::format_to(writer.out(), "{:p}\n", value);
+            std::format_to(std::back_inserter(expected), "{:p}\n", value);
+        }
+        writer.write(std::string(10'000, 'z'));
+        expected.append(10'000, 'z');
+        EXPECT_EQ(writer.size(), expected.size());
+        writer.close();
+        EXPECT_EQ(writer.size(), expected.size());
+        EXPECT_THROW(writer.push_back('x'), std::logic_error);
+        EXPECT_THROW(writer.write("x"), std::logic_error);
+    }
+
+    EXPECT_EQ(read_all(fd), expected);
+    ::close(fd);
+    ::unlink(path.data());
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// Test Suite: Serialization (JSON / TOML)
+// -----------------------------------------------------------------------------
+
+#ifdef FMTU_ENABLE_JSON
+TEST(FormatTests, JSON_Compact)
+{
+    std::string result = std::format("{:j}", SimpleAggregate{ 10, 20.5, true });
+    std::string expected = R"({"id":10,"value":20.5,"active":true})";
+    EXPECT_EQ(result, expected);
+}
+
+TEST(FormatTests, JSON_Pretty)
+{
+    std::string result = std::format("{:pj}", ClassWithAdapter{ 100, "TestObj" });
+    std::string expected = R"({
+   "id": 100,
+   "name": "TestObj"
+})";
+    EXPECT_EQ(result, expected);
+}
+
+TEST(FormatTests, JSON_RepeatedReusesBuffer)
+{
+    std::string result =
+      std::format("{:pj} {:j}", ClassWithAdapter{ 100, "TestObj" }, SimpleAggregate{ 1, 2.5, false });
+    result += std::format("|{:j}", SimpleAggregate{ 10, 20.5, true });
+    std::string expected = R"({
+   "id": 100,
+   "name": "TestObj"
+} {"id":1,"value":2.5,"active":false}|{"id":10,"value":20.5,"active":true})";
+    EXPECT_EQ(result, expected);
+}
+#endif
+
+#ifdef FMTU_ENABLE_YAML
+TEST(FormatTests, YAML_Basic)
+{
+    std::string result = std::format("{:y}", ClassWithAdapter{ 100, "TestObj" });
+    std::string expected = "id:\n100name:\nTestObj";
+    EXPECT_EQ(result, expected);
+}
+#endif
+
+#ifdef FMTU_ENABLE_TOML
+TEST(FormatTests, TOML_Basic)
+{
+    std::string result = std::format("{:t}", ClassWithAdapter{ 100, "TestObj" });
+    std::string expected = R"(id = 100
+name = "TestObj")";
+    EXPECT_EQ(result, expected);
+}
+#endif
+
+#ifdef FMTU_ENABLE_BEVE
+TEST(FormatTests, BEVE_RoundTrip)
+{
+    std::string result = std::format("{:b}", SimpleAggregate{ 10, 20.5, true });
+
+    SimpleAggregate parsed{};
+    EXPECT_FALSE(glz::read_beve(parsed, result));
+    EXPECT_EQ(parsed.id, 10);
+    EXPECT_EQ(parsed.value, 20.5);
+    EXPECT_EQ(parsed.active, true);
+}
+
+TEST(FormatTests, BEVE_Adapter)
+{
+    ClassWithAdapter value{ 100, "TestObj" };
+    std::string result = std::format("{:b}", value);
+    std::string expected = glz::write_beve(value).value_or("");
+    EXPECT_FALSE(result.empty());
+    EXPECT_EQ(result, expected);
+    EXPECT_THROW((void)std::vformat("{:pb}", std::make_format_args(value)), std::format_error);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Test Suite: Streamable (operator<<)
+// -----------------------------------------------------------------------------
+
+struct StreamableTestStruct
+{
+    int x;
+};
+
+std::ostream& operator<<(std::ostream& os, const StreamableTestStruct& s)
+{
+    return os << "StreamableTestStruct(x=" << s.x << ")";
+}
+
+TEST(FormatTests, Streamable_Ostream)
+{
+    std::string result = std::format("{}", StreamableTestStruct{ 42 });
+    std::string expected = "StreamableTestStruct(x=42)";
+    EXPECT_EQ(result, expected);
+}
+
+struct StreamableNested
+{
+    StreamableTestStruct inner;
+};
+
+std::ostream& operator<<(std::ostream& os, const StreamableNested& s)
+{
+    return os << "StreamableNested(" << std::format("{}", s.inner) << ")";
+}
+
+TEST(FormatTests, Streamable_Nested)
+{
+    std::string result = std::format("{} {}", StreamableNested{ { 1 } }, StreamableTestStruct{ 2 });
+    std::string expected = "StreamableNested(StreamableTestStruct(x=1)) StreamableTestStruct(x=2)";
+    EXPECT_EQ(result, expected);
+}
+
+struct ThousandsPunct : std::numpunct<char>
+{
+    auto do_thousands_sep() const -> char override { return ','; }
+    auto do_grouping() const -> std::string override { return "\3"; }
+};
+
+TEST(FormatTests, Streamable_FollowsGlobalLocale)
+{
+    EXPECT_EQ(std::format("{}", StreamableTestStruct{ 1234567 }), "StreamableTestStruct(x=1234567)");
+
+    const std::locale previous = std::locale::global(std::locale(std::locale::classic(), new ThousandsPunct));
+    std::string grouped = std::format("{}", StreamableTestStruct{ 1234567 });
+    std::locale::global(previous);
+
+    EXPECT_EQ(grouped, "StreamableTestStruct(x=1,234,567)");
+    EXPECT_EQ(std::format("{}", StreamableTestStruct{ 1234567 }), "StreamableTestStruct(x=1234567)");
+}
+
+struct StreamableHex
+{
+    int x;
+};
+
+std::ostream& operator<<(std::ostream& os, const StreamableHex& s) { return os << std::hex << s.x; }
+
+TEST(FormatTests, Streamable_StateIsReset)
+{
+    std::string result = std::format("{} {}", StreamableHex{ 255 }, StreamableTestStruct{ 255 });
+    std::string expected = "ff StreamableTestStruct(x=255)";
+    EXPECT_EQ(result, expected);
+}
+
+struct StreamableSticky
+{
+    int x;
+};
+
+static const int sticky_index = std::ios_base::xalloc();
+
+std::ostream& operator<<(std::ostream& os, const StreamableSticky& s)
+{
+    os << (os.iword(sticky_index) != 0 ? "dirty" : "clean") << (os.exceptions() != std::ios_base::goodbit);
+    os.iword(sticky_index) = s.x;
+    os.exceptions(std::ios_base::badbit);
+    return os << std::boolalpha;
+}
+
+TEST(FormatTests, Streamable_ExtendedStateIsReset)
+{
+    std::string result = std::format("{} {}", StreamableSticky{ 1 }, StreamableSticky{ 2 });
+    std::string expected = "clean0 clean0";
+    EXPECT_EQ(result, expected);
+}
+
+struct StreamableLong
+{
+    size_t n;
+};
+
+std::ostream& operator<<(std::ostream& os, const StreamableLong& s)
+{
+    for (size_t i = 0; i < s.n; ++i) {
+        os << static_cast<char>('a' + i % 26);
+    }
+    return os << std::string(s.n, '-');
+}
+
+TEST(FormatTests, Streamable_LongOutput)
+{
+    std::string result = std::format("{}", StreamableLong{ 1000 });
+    std::string expected{};
+    for (size_t i = 0; i < 1000; ++i) {
+        expected += static_cast<char>('a' + i % 26);
+    }
+    expected += std::string(1000, '-');
+    EXPECT_EQ(result, expected);
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: HasToString (toString(), to_string(), etc.)
+// -----------------------------------------------------------------------------
+
+struct ToStringTestStruct
+{
+    std::string toString() const { return "ToStringTestStruct"; }
+};
+
+TEST(FormatTests, HasToString_MemberToString)
+{
+    std::string result = std::format("{}", ToStringTestStruct{});
+    std::string expected = "ToStringTestStruct";
+    EXPECT_EQ(result, expected);
+}
+
+struct SnakeCaseToStringStruct
+{
+    std::string to_string() const { return "SnakeCaseToStringStruct"; }
+};
+
+TEST(FormatTests, HasToString_MemberSnakeCase)
+{
+    std::string result = std::format("{}", SnakeCaseToStringStruct{});
+    std::string expected = "SnakeCaseToStringStruct";
+    EXPECT_EQ(result, expected);
+}
+
+struct FreeToStringStruct
+{
+};
+
+const char* to_string(const FreeToStringStruct&) { return "FreeToStringStruct"; }
+
+TEST(FormatTests, HasToString_FreeFunction)
+{
+    std::string result = std::format("{}", FreeToStringStruct{});
+    std::string expected = "FreeToStringStruct";
+    EXPECT_EQ(result, expected);
+}
+
+struct StaticToStringStruct
+{
+    static constexpr std::string_view toString() { return "StaticToStringStruct"; }
+};
+
+TEST(FormatTests, HasToString_StaticToString)
+{
+    std::string result = std::format("{}", StaticToStringStruct{});
+    std::string expected = "StaticToStringStruct";
+    EXPECT_EQ(result, expected);
+}
+
+struct FormatToStruct
+{
+    int id;
+    template<typename OutIt>
+    OutIt format_to(OutIt out) const
+    {
+        return std::format_to(out, "FormatToStruct#{}", id);
+    }
+};
+
+TEST(FormatTests, HasToString_MemberFormatTo)
+{
+    std::string result = std::format("{}", FormatToStruct{ 7 });
+    std::string expected = "FormatToStruct#7";
+    EXPECT_EQ(result, expected);
+}
+
+struct AppendToStruct
+{
+    int id;
+    void append_to(std::string& str) const
+    {
+        str += "AppendToStruct#";
+        str += std::to_string(id);
+    }
+};
+
+TEST(FormatTests, HasToString_MemberAppendTo)
+{
+    std::string result = std::format("{} {}", AppendToStruct{ 1 }, AppendToStruct{ 2 });
+    std::string expected = "AppendToStruct#1 AppendToStruct#2";
+    EXPECT_EQ(result, expected);
+}
+
+struct FreeAppendToStruct
+{
+    AppendToStruct inner;
+};
+
+void append_to(const FreeAppendToStruct& s, std::string& str)
+{
+    str += "FreeAppendToStruct(";
+    str += std::format("{}", s.inner);
+    str += ")";
+}
+
+TEST(FormatTests, HasToString_FreeAppendToNested)
+{
+    std::string result = std::format("{}", FreeAppendToStruct{ { 3 } });
+    std::string expected = "FreeAppendToStruct(AppendToStruct#3)";
+    EXPECT_EQ(result, expected);
+}
+
+struct ThrowingAppendToStruct
+{
+    void append_to(std::string& str) const
+    {
+        str += "partial";
+        throw std::runtime_error("append failed");
+    }
+};
+
+TEST(FormatTests, HasToString_ThrowingAppendToReleasesBuffer)
+{
+    const FreeAppendToStruct nested{ { 4 } };
+    EXPECT_THROW((void)std::format("{} {}", nested, ThrowingAppendToStruct{}), std::runtime_error);
+    EXPECT_THROW((void)std::format("{}", ThrowingAppendToStruct{}), std::runtime_error);
+
+    std::string result = std::format("{}", FreeAppendToStruct{ { 5 } });
+    std::string expected = "FreeAppendToStruct(AppendToStruct#5)";
+    EXPECT_EQ(result, expected);
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Format Priority
+// Priority: Adapter > Streamable > HasToString > Reflection
+// -----------------------------------------------------------------------------
+
+struct PriorityAdapter
+{
+    int val = 1;
+    std::string toString() const { return "ToString"; }
+};
+
+std::ostream& operator<<(std::ostream& os, const PriorityAdapter&) { return os << "Streamable"; }
+
+template<>
+struct fmtu::Adapter<PriorityAdapter>
+{
+    using Fields = std::tuple<fmtu::Field<"val", &PriorityAdapter::val>>;
+};
+
+TEST(FormatTests, Priority_Adapter)
+{
+    std::string result = std::format("{}", PriorityAdapter{});
+    std::string expected = "[ PriorityAdapter: { val: 1 } ]";
+    EXPECT_EQ(result, expected);
+}
+
+struct PriorityStreamable
+{
+    int val = 2;
+    std::string toString() const { return "ToString"; }
+};
+
+std::ostream& operator<<(std::ostream& os, const PriorityStreamable& s)
+{
+    return os << "Streamable " << s.val;
+}
+
+TEST(FormatTests, Priority_Streamable)
+{
+    std::string result = std::format("{}", PriorityStreamable{});
+    std::string expected = "Streamable 2";
+    EXPECT_EQ(result, expected);
+}
+
+struct PriorityToString
+{
+    int val = 3;
+    std::string toString() const { return "ToString " + std::to_string(val); }
+};
+
+TEST(FormatTests, Priority_ToString)
+{
+    std::string result = std::format("{}", PriorityToString{});
+    std::string expected = "ToString 3";
+    EXPECT_EQ(result, expected);
+}
+
+struct PriorityReflection
+{
+    int val = 4;
+};
+
+TEST(FormatTests, Priority_Reflection)
+{
+    std::string result = std::format("{}", PriorityReflection{});
     std::string expected = "[ PriorityReflection: { val: 4 } ]";
     EXPECT_EQ(result, expected);
 }
 
+// -----------------------------------------------------------------------------
+// Test Suite: Snapshot Diff
+// -----------------------------------------------------------------------------
+
+TEST(FormatTests, Diff_NestedAggregate)
+{
+    NestedAggregate before{ "state", { 1, 0.5, true } };
+    NestedAggregate after{ "state", { 2, 0.5, false } };
+    EXPECT_EQ(fmtu::format_diff(before, after), "simple.id: 1 -> 2, simple.active: true -> false");
+    EXPECT_EQ(std::format("{:p}", fmtu::diff(before, after)),
+              "simple.id: 1 -> 2\nsimple.active: true -> false");
+    EXPECT_EQ(fmtu::format_diff(before, before), "");
+}
+
+TEST(FormatTests, Diff_AdapterByValue)
+{
+    EXPECT_EQ(fmtu::format_diff(ClassWithNestedAdapter{ 3 }, ClassWithNestedAdapter{ 4 }),
+              "simple.id: 3 -> 4, inner.id: 6 -> 8");
+    EXPECT_EQ(fmtu::format_diff(ClassWithAdapter{ 1, "old" }, ClassWithAdapter{ 1, "new" }),
+              "name: old -> new");
+}
+
+TEST(FormatTests, Diff_ComparesContainersOfAggregatesElementwise)
+{
+    using Containers = AggregateWithAggregateContainers;
+    Containers before{ 1, { { 1, 0.5, true } }, { { { 2, 0.5, true } } }, std::nullopt };
+    Containers after{ 2, {}, { { { 3, 0.5, false } } }, SimpleAggregate{ 4, 0.5, true } };
+    std::string expected = std::format("id: 1 -> 2, items: {} -> {}, pinned: {} -> {}, extra: {} -> {}",
+                                       before.items,
+                                       after.items,
+                                       before.pinned,
+                                       after.pinned,
+                                       before.extra,
+                                       after.extra);
+    EXPECT_EQ(fmtu::format_diff(before, after), expected);
+
+    Containers copy{ 1, { { 1, 0.5, true } }, { { { 2, 0.5, true } } }, std::nullopt };
+    EXPECT_EQ(fmtu::format_diff(before, copy), "");
+
+    static_assert(fmtu::detail::ValueComparable<std::optional<std::pair<int, SimpleAggregate>>>);
+    static_assert(!fmtu::detail::ValueComparable<std::vector<std::mutex>>);
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Projection
+// -----------------------------------------------------------------------------
+
+TEST(FormatTests, Projection_Compact)
+{
+    SimpleAggregate value{ 42, 3.14, true };
+    std::string result = std::format("{}", fmtu::project<"active", "id">(value));
+    std::string expected = "[ SimpleAggregate: { active: true, id: 42 } ]";
+    EXPECT_EQ(result, expected);
+
+    NestedAggregate nested{ "Parent", { 1, 1.5, false } };
+    EXPECT_EQ(std::format("{}", fmtu::project<"simple">(nested)),
+              "[ NestedAggregate: { simple: [ SimpleAggregate: { id: 1, value: 1.5, active: false } ] } ]");
+}
+
+TEST(FormatTests, Projection_PrettyAdapter)
+{
+    ClassWithNestedAdapter value{ 3 };
+    std::string result = std::format("{:p}", fmtu::project<"inner">(value));
+    std::string expected = R"(ClassWithNestedAdapter: {
+  inner: {
+    id: 6,
+    name: Inner
+  }
+})";
+    EXPECT_EQ(result, expected);
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Cached Formatting
+// -----------------------------------------------------------------------------
+
+TEST(FormatTests, Cached_InvalidatesOnChange)
+{
+    fmtu::Cached<NestedAggregate> cached{ NestedAggregate{ "Parent", { 1, 1.5, true } } };
+    EXPECT_EQ(std::format("{}", cached), std::format("{}", cached.value()));
+    EXPECT_EQ(std::format("{:p}|{:p}", cached, cached),
+              std::format("{:p}|{:p}", cached.value(), cached.value()));
+
+    cached.modify().simple.id = 2;
+    EXPECT_EQ(std::format("{}", cached), std::format("{}", cached.value()));
+    EXPECT_EQ(std::format("{:p}", cached), std::format("{:p}", cached.value()));
+}
+
+struct AggregateWithPointers
+{
+    const int* raw;
+    std::shared_ptr<int> shared;
+};
+
+TEST(FormatTests, Cached_InvalidatesOnPointeeChange)
+{
+    int target = 1;
+    fmtu::Cached<AggregateWithPointers> cached{ AggregateWithPointers{ &target, std::make_shared<int>(2) } };
+    EXPECT_EQ(std::format("{}", cached), std::format("{}", cached.value()));
+
+    target = 3;
+    EXPECT_EQ(std::format("{}", cached), std::format("{}", cached.value()));
+
+    *cached.value().shared = 4;
+    EXPECT_EQ(std::format("{}", cached), std::format("{}", cached.value()));
+}
+
+TEST(FormatTests, Cached_RetainedOutputsStayBounded)
+{
+    // The pointee changes without modify(), every format replaces the cached output.
+    int target = 0;
+    fmtu::Cached<AggregateWithPointers> cached{ AggregateWithPointers{ &target, std::make_shared<int>(0) } };
+    for (; target < 1'000; ++target) {
+        EXPECT_EQ(std::format("{}", cached), std::format("{}", cached.value()));
+        EXPECT_EQ(cached.retained_entries(), 1u);
+    }
+}
+
+TEST(FormatTests, Cached_RejectsSpecsItCannotReplay)
+{
+    fmtu::Cached<double> cached{ 1.5 };
+    EXPECT_EQ(std::format("{:>8}", cached), "     1.5");
+
+    int width = 8;
+    EXPECT_THROW((void)std::vformat("{:{}}", std::make_format_args(cached, width)), std::format_error);
+    EXPECT_THROW((void)std::vformat("{:*^+#030.10000e}", std::make_format_args(cached)), std::format_error);
+}
+
+TEST(FormatTests, Cached_InvalidatesOnSignedZero)
+{
+    fmtu::Cached<SimpleAggregate> cached{ SimpleAggregate{ 1, 0.0, true } };
+    EXPECT_EQ(std::format("{}", cached), "[ SimpleAggregate: { id: 1, value: 0, active: true } ]");
+
+    cached.modify().value = -0.0;
+    EXPECT_EQ(std::format("{}", cached), "[ SimpleAggregate: { id: 1, value: -0, active: true } ]");
+}
+
+TEST(FormatTests, Cached_ConcurrentReaders)
+{
+    fmtu::Cached<ClassWithNestedAdapter> cached{ ClassWithNestedAdapter{ 5 } };
+    const std::string expected = std::format("{}", cached.value());
+
+    std::atomic<int> mismatches = 0;
+    {
+        std::vector<std::jthread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                for (int i = 0; i < 1'000; ++i) {
+                    if (std::format("{}", cached) != expected) {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Fixed Capacity
+// -----------------------------------------------------------------------------
+
+struct FixedWithToStringMember
+{
+    int id;
+    ToStringTestStruct inner;
+};
+
+TEST(FormatTests, Fixed_FitsWithoutTruncation)
+{
+    auto result = fmtu::format_to_fixed<128>("{} {:v}", SimpleAggregate{ 1, 0.5, true }, TestEnum::ValueB);
+    EXPECT_FALSE(result.truncated);
+    EXPECT_EQ(result.view(), std::format("{} {:v}", SimpleAggregate{ 1, 0.5, true }, TestEnum::ValueB));
+
+    auto format_to = fmtu::format_to_fixed<64>("{}|{}", FormatToStruct{ 3 }, FormatToStruct{ 4 });
+    EXPECT_EQ(std::string_view{ format_to }, "FormatToStruct#3|FormatToStruct#4");
+}
+
+TEST(FormatTests, Fixed_Truncates)
+{
+    auto result = fmtu::format_to_fixed<64>("{:p}", NestedAggregate{ "name", { 1, 0.5, true } });
+    std::string full = std::format("{:p}", NestedAggregate{ "name", { 1, 0.5, true } });
+    ASSERT_GT(full.size(), 64u);
+    EXPECT_TRUE(result.truncated);
+    EXPECT_EQ(result.size(), 64u);
+    EXPECT_EQ(result.view(), std::string_view{ full }.substr(0, 64));
+}
+
+TEST(FormatTests, Fixed_CompileTimeChecks)
+{
+    static_assert(fmtu::detail::HeapFreeFormattable<NestedAggregate>);
+    static_assert(fmtu::detail::HeapFreeFormattable<std::optional<FormatToStruct>>);
+    static_assert(!fmtu::detail::HeapFreeFormattable<ToStringTestStruct>);
+    static_assert(!fmtu::detail::HeapFreeFormattable<AppendToStruct>);
+    static_assert(!fmtu::detail::HeapFreeFormattable<FixedWithToStringMember>);
+    static_assert(!fmtu::detail::HeapFreeFormattable<StreamableTestStruct>);
+    static_assert(!fmtu::detail::HeapFreeFormattable<std::vector<StreamableNested>>);
+
+    constexpr auto min_size = fmtu::detail::fixed_format_min_size<SimpleAggregate, int>("<{0}> {1:>8}");
+    static_assert(min_size == 3 + fmtu::formatted_size_hint<SimpleAggregate>().lower);
+}
+
+// True if fixed_format_min_size accepts the pattern, i.e. format_to_fixed would compile.
+template<reflect::fixed_string Pattern, typename... Args>
+constexpr bool ACCEPTED_BY_FORMAT_TO_FIXED = requires {
+    typename std::integral_constant<
+      size_t, fmtu::detail::fixed_format_min_size<Args...>(std::string_view{ Pattern })>;
+};
+
+TEST(FormatTests, Fixed_RejectsSerializationThroughWrappers)
+{
+    static_assert(ACCEPTED_BY_FORMAT_TO_FIXED<"{}", std::optional<SimpleAggregate>>);
+    static_assert(ACCEPTED_BY_FORMAT_TO_FIXED<"{::b}", std::vector<int>>);
+    static_assert(!ACCEPTED_BY_FORMAT_TO_FIXED<"{:j}", SimpleAggregate>);
+    static_assert(!ACCEPTED_BY_FORMAT_TO_FIXED<"{:j}", std::optional<SimpleAggregate>>);
+    static_assert(!ACCEPTED_BY_FORMAT_TO_FIXED<"{:j}", const SimpleAggregate*>);
+    static_assert(!ACCEPTED_BY_FORMAT_TO_FIXED<"{:y}", std::unique_ptr<SimpleAggregate>>);
+    static_assert(!ACCEPTED_BY_FORMAT_TO_FIXED<"{::t}", std::vector<SimpleAggregate>>);
+    static_assert(!ACCEPTED_BY_FORMAT_TO_FIXED<"{::b}", std::array<std::optional<SimpleAggregate>, 2>>);
+}
+
+// -----------------------------------------------------------------------------
+// Test Suite: Out-of-line Formatters
+// -----------------------------------------------------------------------------
+
+// The formatters are defined in out_of_line_types.cpp, this file only sees their declarations. The
+// DeclaredAggregate member of DeclaredAdapter is inlined into the adapter's pattern like any other class.
+TEST(FormatTests, OutOfLine_MatchesInline)
+{
+    static_assert(std::is_base_of_v<fmtu::detail::ClassFormatter<DeclaredAggregate>,
+                                    std::formatter<DeclaredAggregate>>);
+
+    std::string result = std::format("{}", DeclaredAdapter{ 2 });
+    std::string expected = "[ DeclaredAdapter: { id: 2, aggregate: [ DeclaredAggregate: { id: 2, inner: [ "
+                           "DeclaredInner: { id: 2, value: 0.5, active: true } ] } ] } ]";
+    EXPECT_EQ(result, expected);
+
+    result = std::format("{:p}", DeclaredAggregate{ 1, { 3, 1.5, false } });
+    expected = R"(DeclaredAggregate: {
+  id: 1,
+  inner: {
+    id: 3,
+    value: 1.5,
+    active: false
+  }
+})";
+    EXPECT_EQ(result, expected);
+}
+
+#ifdef FMTU_ENABLE_STATS
+// -----------------------------------------------------------------------------
+// Test Suite: Formatting Statistics
+// -----------------------------------------------------------------------------
+
+struct StatsRecord
+{
+    int id;
+    SimpleAggregate inner;
+};
+
+enum class StatsEnum
+{
+    Idle,
+    Busy
+};
+
+static auto find_stats(std::string_view type, std::string_view spec) -> std::optional<fmtu::stats::TypeStats>
+{
+    for (auto& entry : fmtu::stats::snapshot()) {
+        if (entry.type == type && entry.spec == spec) {
+            return entry;
+        }
+    }
+    return std::nullopt;
+}
+
+TEST(FormatTests, Stats_CountsCallsAndBytes)
+{
+    const StatsRecord record{ 7, { 1, 0.5, true } };
+    const std::string compact = std::format("{}", record);
+    const std::string pretty = std::format("{:p}", record);
+    std::thread{ [&] { EXPECT_EQ(std::format("{}", record), compact); } }.join();
+
+    auto compact_stats = find_stats("StatsRecord", "");
+    ASSERT_TRUE(compact_stats.has_value());
+    EXPECT_EQ(compact_stats->calls, 2u);
+    EXPECT_EQ(compact_stats->bytes, 2 * compact.size());
+    EXPECT_EQ(std::accumulate(compact_stats->latency_ns.begin(), compact_stats->latency_ns.end(), 0ULL), 2u);
+
+    auto pretty_stats = find_stats("StatsRecord", "p");
+    ASSERT_TRUE(pretty_stats.has_value());
+    EXPECT_EQ(pretty_stats->calls, 1u);
+    EXPECT_EQ(pretty_stats->bytes, pretty.size());
+}
+
+TEST(FormatTests, Stats_CountsEnums)
+{
+    const std::string verbose = std::format("{:v}", StatsEnum::Busy);
+
+    auto enum_stats = find_stats("StatsEnum", "v");
+    ASSERT_TRUE(enum_stats.has_value());
+    EXPECT_EQ(enum_stats->calls, 1u);
+    EXPECT_EQ(enum_stats->bytes, verbose.size());
+}
+
+TEST(FormatTests, Stats_ExitedThreadCountersAreReused)
+{
+    const StatsRecord record{ 8, { 2, 1.5, false } };
+    std::thread{ [&] { (void)std::format("{:v}", record); } }.join();
+    const size_t registered = fmtu::detail::stats_registry().counters.size();
+
+    for (int i = 0; i < 16; ++i) {
+        std::thread{ [&] { (void)std::format("{:v}", record); } }.join();
+    }
+    EXPECT_EQ(fmtu::detail::stats_registry().counters.size(), registered);
+
+    auto verbose_stats = find_stats("StatsRecord", "v");
+    ASSERT_TRUE(verbose_stats.has_value());
+    EXPECT_EQ(verbose_stats->calls, 17u);
+}
+#endif
+
 // NOLINTEND
@@ -0,0 +1,4 @@
+#include "out_of_line_types.hpp"
+
+FMTU_DEFINE_FORMATTER(DeclaredAggregate)
+FMTU_DEFINE_FORMATTER(DeclaredAdapter)
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "format_utils.hpp"
+
+// NOLINTBEGIN
+
+// Types with out-of-line formatters. The formatters are declared here and defined only in
+// out_of_line_types.cpp, so format_tests.cpp links against the single definition.
+
+struct DeclaredInner
+{
+    int id;
+    double value;
+    bool active;
+};
+
+struct DeclaredAggregate
+{
+    int id;
+    DeclaredInner inner;
+};
+
+FMTU_DECLARE_FORMATTER(DeclaredAggregate);
+
+class DeclaredAdapter
+{
+  public:
+    explicit DeclaredAdapter(int id)
+      : m_id(id)
+    {
+    }
+
+    int getId() const { return m_id; }
+    DeclaredAggregate getAggregate() const { return { m_id, { m_id, 0.5, true } }; }
+
+  private:
+    int m_id;
+};
+
+template<>
+struct fmtu::Adapter<DeclaredAdapter>
+{
+    using Fields = std::tuple<fmtu::Field<"id", &DeclaredAdapter::getId>,
+                              fmtu::Field<"aggregate", &DeclaredAdapter::getAggregate>>;
+};
+
+FMTU_DECLARE_FORMATTER(DeclaredAdapter);
+
+// NOLINTEND